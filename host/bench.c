@@ -0,0 +1,380 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// Host benchmarks of the app's hot paths, driven through the host stand-in for the SDK (see
+// pebble_host.h). The app is built into this file so its static functions can be timed
+// directly. Each benchmark reports host nanoseconds per operation, which are useful to compare
+// changes, not as watch timings.
+//
+// Usage: bench [persist file]. The persistent store is loaded from the file if given and saved
+// back to it on exit. Set WC_LOG=1 to see APP_LOG output.
+
+#define main app_main
+#include "../src/button_click.c"
+#undef main
+
+#include "pebble_host.h"
+
+#define BENCH_REPEAT 10000
+#define BENCH_SLOW_REPEAT 1000
+#define BENCH_RESTART_REPEAT 100
+#define BENCH_SESSION_REPEAT 50
+
+// Time a split is made at, one second apart.
+#define BENCH_SPLIT_MS 1000
+
+#ifdef PBL_COLOR
+#define BENCH_PLATFORM "basalt"
+#else
+#define BENCH_PLATFORM "aplite"
+#endif
+
+static struct timespec benchStart;
+
+
+static void bench_begin()
+{
+  clock_gettime(CLOCK_MONOTONIC, &benchStart);
+}
+
+
+static void bench_end(const char *name, int repeat)
+{
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  double ns = (end.tv_sec - benchStart.tv_sec) * 1e9 + (end.tv_nsec - benchStart.tv_nsec);
+  printf("%-8s %-34s %12.0f ns/op  (%i ops)\n", BENCH_PLATFORM, name, ns / repeat, repeat);
+}
+
+
+static void bench_fail(const char *what)
+{
+  fprintf(stderr, "bench: %s\n", what);
+  exit(1);
+}
+
+
+//##################### App control #########################################
+
+// Exit and start the app again, as on the watch: state goes through the persistent store.
+// Window and timer handles are cleared as a fresh process would have them.
+static void bench_app_restart()
+{
+  app_deinit();
+  host_reset();
+
+  option_window = NULL;
+  menu_window = NULL;
+  split_window = NULL;
+  session_window = NULL;
+  inputDrainTimerHandle = NULL;
+  resetTimerHandle = NULL;
+  fastRedrawTimerHandle = NULL;
+  tickUnits = NO_TICK_UNITS;
+
+  app_init();
+  app_event_loop();
+}
+
+
+// Switch the time window to or from chrono mode with a long UP press.
+static void bench_set_mode(short mode)
+{
+  if (selectedMode != mode)
+  {
+    host_hold(BUTTON_ID_UP, 300);
+  }
+}
+
+
+static void bench_set_running(bool running)
+{
+  if (chrono_running() != running)
+  {
+    host_click(BUTTON_ID_SELECT);
+  }
+}
+
+
+// Split the running chronometer with the DOWN button, a second after the previous split.
+static void bench_split()
+{
+  host_advance_ms(BENCH_SPLIT_MS);
+  host_click(BUTTON_ID_DOWN);
+}
+
+
+//##################### Benchmarks ##########################################
+
+// Clock display on each second tick, including the render of the time window.
+static void bench_second_tick()
+{
+  bench_set_mode(MODE_CLOCK);
+
+  time_t now = time(NULL);
+  struct tm tickTime = *localtime(&now);
+  bench_begin();
+  for (int i = 0; i < BENCH_REPEAT; i++)
+  {
+    tickTime.tm_sec = i % 60;
+    tickTime.tm_min = (i / 60) % 60;
+    tc_handle_second_tick(&tickTime, (i % 60 == 0) ? SECOND_UNIT | MINUTE_UNIT : SECOND_UNIT);
+    host_render();
+  }
+  bench_end("second tick", BENCH_REPEAT);
+}
+
+
+// Running chronometer redrawn by its tenths timer, including the render.
+static void bench_chrono_tenths()
+{
+  bench_set_mode(MODE_CHRON);
+  bench_set_running(true);
+
+  bench_begin();
+  for (int i = 0; i < BENCH_REPEAT; i++)
+  {
+    host_advance_ms(FAST_REDRAW_MS);
+  }
+  bench_end("chrono tenths redraw", BENCH_REPEAT);
+}
+
+
+// Split into a full buffer, replacing the oldest, through the DOWN button: press timestamp,
+// queued input, drain, journal record and redraw.
+static void bench_full_split_press()
+{
+  settings_set(SETTING_REPLACE_OLDEST, true);
+  bench_set_mode(MODE_CHRON);
+  bench_set_running(true);
+
+  while ( ! split_ring_full(chrono_splits()))
+  {
+    bench_split();
+  }
+
+  bench_begin();
+  for (int i = 0; i < BENCH_SLOW_REPEAT; i++)
+  {
+    bench_split();
+  }
+  bench_end("full split insert (press)", BENCH_SLOW_REPEAT);
+}
+
+
+// Split into a full buffer, replacing the oldest, of the ring alone.
+static void bench_full_split_ring()
+{
+  static uint32_t times[MAX_SPLITS];
+  split_ring_S ring;
+
+  split_ring_init(&ring, times, MAX_SPLITS);
+  while ( ! split_ring_full(&ring))
+  {
+    split_ring_push(&ring, split_ring_count(&ring) * BENCH_SPLIT_MS);
+  }
+
+  bench_begin();
+  for (int i = 0; i < BENCH_REPEAT; i++)
+  {
+    split_ring_push(&ring, (MAX_SPLITS + i) * BENCH_SPLIT_MS);
+  }
+  bench_end("full split insert (ring)", BENCH_REPEAT);
+}
+
+
+static void bench_lap_stats()
+{
+  lap_stats_S stats;
+  lap_stats_clear(&stats);
+
+  bench_begin();
+  for (int i = 0; i < BENCH_REPEAT; i++)
+  {
+    lap_stats_add(&stats, i * BENCH_SPLIT_MS + i % 7);
+  }
+  bench_end("lap stats add", BENCH_REPEAT);
+}
+
+
+// Splits page text of the selected chronometer, paging through its splits and then its laps,
+// with the splits window loaded.
+static void bench_splits_page()
+{
+  split_window_push();
+
+  int pages = (splits_display_rows() + MAX_DISPLAY_SPLITS - 1) / MAX_DISPLAY_SPLITS;
+  bench_begin();
+  for (int i = 0; i < BENCH_REPEAT; i++)
+  {
+    splitDisplayIndex = (i % pages) * MAX_DISPLAY_SPLITS;
+    select_splits_display_content();
+  }
+  bench_end("splits page format", BENCH_REPEAT);
+
+  splitsShowLaps = true;
+  pages = (splits_display_rows() + MAX_DISPLAY_SPLITS - 1) / MAX_DISPLAY_SPLITS;
+  bench_begin();
+  for (int i = 0; i < BENCH_REPEAT; i++)
+  {
+    splitDisplayIndex = (i % pages) * MAX_DISPLAY_SPLITS;
+    select_splits_display_content();
+  }
+  bench_end("laps page format", BENCH_REPEAT);
+  splitsShowLaps = false;
+
+  window_stack_pop(false);
+}
+
+
+// Reset of a stopped chronometer holding splits, with Reset clearing them, which archives them as
+// a session first. Done on the second chronometer while the first holds a full buffer, so
+// sessions compete with the live state for persistent storage.
+static void bench_session_archive()
+{
+  settings_set(SETTING_RESET_CLEARS_SPLITS, true);
+  bench_set_mode(MODE_CHRON);
+  host_click(BUTTON_ID_UP);
+
+  bench_begin();
+  for (int i = 0; i < BENCH_SESSION_REPEAT; i++)
+  {
+    bench_set_running(true);
+    for (int j = 0; j < OTHER_MAX_SPLITS; j++)
+    {
+      bench_split();
+    }
+    bench_set_running(false);
+    host_hold(BUTTON_ID_DOWN, 1100);
+  }
+  bench_end("splits, reset and archive", BENCH_SESSION_REPEAT);
+
+  for (int i = 1; i < CHRONO_COUNT; i++)
+  {
+    host_click(BUTTON_ID_UP);
+  }
+}
+
+
+// Splits and lap statistics of one chronometer as they were before a restart.
+typedef struct bench_splits_S
+{
+  int count;
+  uint32_t before;
+  uint32_t dropped;
+  uint32_t times[MAX_SPLITS];
+  lap_stats_S stats;
+} bench_splits_S;
+
+static bench_splits_S benchSplits[CHRONO_COUNT];
+
+
+static void bench_splits_get(bench_splits_S *splits)
+{
+  const split_ring_S *ring = chrono_splits();
+  *splits = (bench_splits_S){.count = split_ring_count(ring), .before = ring->before, .dropped = ring->dropped,
+                             .stats = *chrono_lap_stats()};
+
+  split_ring_iter_S iter = split_ring_iter(ring, 0);
+  for (int i = 0; i < splits->count; i++)
+  {
+    split_ring_next(&iter, &splits->times[i]);
+  }
+}
+
+
+// Give the second chronometer more splits than its ring holds, so some are replaced.
+static void bench_fill_other_chrono()
+{
+  settings_set(SETTING_REPLACE_OLDEST, true);
+  bench_set_mode(MODE_CHRON);
+
+  host_click(BUTTON_ID_UP);
+  bench_set_running(true);
+  for (int i = 0; i < OTHER_MAX_SPLITS + OTHER_MAX_SPLITS / 2; i++)
+  {
+    bench_split();
+  }
+
+  // Back to the first chronometer.
+  for (int i = 1; i < CHRONO_COUNT; i++)
+  {
+    host_click(BUTTON_ID_UP);
+  }
+}
+
+
+// Exit and restart with chronometers running and holding splits. The splits and lap statistics
+// of each must come back as they were.
+static void bench_restart()
+{
+  int selected = chrono_selected();
+  bool running = chrono_running();
+  for (int i = 0; i < CHRONO_COUNT; i++)
+  {
+    chrono_select(i);
+    bench_splits_get(&benchSplits[i]);
+  }
+  chrono_select(selected);
+
+  bench_begin();
+  for (int i = 0; i < BENCH_RESTART_REPEAT; i++)
+  {
+    bench_app_restart();
+  }
+  bench_end("exit and restart (persist)", BENCH_RESTART_REPEAT);
+
+  if (chrono_selected() != selected || chrono_running() != running)
+  {
+    bench_fail("restart lost the run state");
+  }
+  for (int i = 0; i < CHRONO_COUNT; i++)
+  {
+    static bench_splits_S restored;
+    chrono_select(i);
+    bench_splits_get(&restored);
+    if (memcmp(&restored, &benchSplits[i], sizeof(restored)) != 0)
+    {
+      bench_fail("restart changed the splits or lap statistics");
+    }
+  }
+  chrono_select(selected);
+
+  printf("%-8s %-34s %12i bytes\n", BENCH_PLATFORM, "persistent store used", host_persist_used_bytes());
+}
+
+
+int main(int argc, char *argv[])
+{
+  const char *persistPath = (argc > 1) ? argv[1] : NULL;
+  const char *log = getenv("WC_LOG");
+
+  host_log_enable(log != NULL && strcmp(log, "1") == 0);
+  host_clock_set_ms(1420070400000LL); // 2015-01-01 00:00:00 UTC.
+  if (persistPath != NULL && ! host_persist_load(persistPath))
+  {
+    bench_fail("cannot load the persistent store");
+  }
+
+  app_init();
+  app_event_loop();
+
+  bench_second_tick();
+  bench_chrono_tenths();
+  bench_full_split_press();
+  bench_session_archive();
+  bench_fill_other_chrono();
+  bench_full_split_ring();
+  bench_lap_stats();
+  bench_splits_page();
+  bench_restart();
+
+  app_deinit();
+  host_reset();
+
+  if (persistPath != NULL && ! host_persist_save(persistPath))
+  {
+    bench_fail("cannot save the persistent store");
+  }
+
+  return 0;
+}
@@ -0,0 +1,379 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// Stand-in for the Pebble SDK header, for building the app on a Linux host. Only the parts of
+// the SDK the app uses are declared, with the same names and signatures. They are implemented
+// in pebble_host.c over a simulated clock, an in-memory persistent store that can be loaded from
+// and saved to a file, and a host frame buffer. See pebble_host.h for the harness controls.
+// PBL_COLOR is defined by the build for the color platform, as by the SDK.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+//##################### Types ###############################################
+
+typedef struct Window Window;
+typedef struct Layer Layer;
+typedef struct TextLayer TextLayer;
+typedef struct BitmapLayer BitmapLayer;
+typedef struct SimpleMenuLayer SimpleMenuLayer;
+typedef struct GBitmap GBitmap;
+typedef struct GContext GContext;
+typedef struct GFontInfo *GFont;
+typedef struct AppTimer AppTimer;
+typedef void *ClickRecognizerRef;
+typedef const void *ResHandle;
+
+typedef struct GPoint
+{
+  int16_t x;
+  int16_t y;
+} GPoint;
+
+typedef struct GSize
+{
+  int16_t w;
+  int16_t h;
+} GSize;
+
+typedef struct GRect
+{
+  GPoint origin;
+  GSize size;
+} GRect;
+
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+
+typedef union GColor8
+{
+  uint8_t argb;
+  struct
+  {
+    uint8_t b : 2;
+    uint8_t g : 2;
+    uint8_t r : 2;
+    uint8_t a : 2;
+  };
+} GColor8;
+
+typedef GColor8 GColor;
+
+#define gcolor_equal(a, b) ((a).argb == (b).argb)
+
+typedef enum
+{
+  SECOND_UNIT = 1 << 0,
+  MINUTE_UNIT = 1 << 1,
+  HOUR_UNIT = 1 << 2,
+  DAY_UNIT = 1 << 3,
+  MONTH_UNIT = 1 << 4,
+  YEAR_UNIT = 1 << 5,
+} TimeUnits;
+
+typedef enum
+{
+  BUTTON_ID_BACK,
+  BUTTON_ID_UP,
+  BUTTON_ID_SELECT,
+  BUTTON_ID_DOWN,
+  NUM_BUTTONS,
+} ButtonId;
+
+typedef enum
+{
+  GTextAlignmentLeft,
+  GTextAlignmentCenter,
+  GTextAlignmentRight,
+} GTextAlignment;
+
+typedef enum
+{
+  GTextOverflowModeWordWrap,
+  GTextOverflowModeTrailingEllipsis,
+  GTextOverflowModeFill,
+} GTextOverflowMode;
+
+typedef enum
+{
+  GCompOpAssign,
+  GCompOpAssignInverted,
+  GCompOpOr,
+  GCompOpAnd,
+  GCompOpClear,
+  GCompOpSet,
+} GCompOp;
+
+typedef enum
+{
+  GBitmapFormat1Bit,
+  GBitmapFormat8Bit,
+  GBitmapFormat1BitPalette,
+  GBitmapFormat2BitPalette,
+  GBitmapFormat4BitPalette,
+} GBitmapFormat;
+
+typedef enum
+{
+  GCornerNone = 0,
+} GCornerMask;
+
+typedef enum
+{
+  APP_LOG_LEVEL_ERROR = 1,
+  APP_LOG_LEVEL_WARNING = 50,
+  APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200,
+} AppLogLevel;
+
+// Status codes returned by persist_ functions.
+#define S_SUCCESS 0
+#define E_OUT_OF_STORAGE (-6)
+#define E_DOES_NOT_EXIST (-9)
+
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef void (*ClickConfigProvider)(void *context);
+typedef void (*WindowHandler)(Window *window);
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+typedef void (*AppTimerCallback)(void *data);
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+typedef void (*SimpleMenuLayerSelectCallback)(int index, void *context);
+
+typedef struct WindowHandlers
+{
+  WindowHandler load;
+  WindowHandler appear;
+  WindowHandler disappear;
+  WindowHandler unload;
+} WindowHandlers;
+
+typedef struct SimpleMenuItem
+{
+  const char *title;
+  const char *subtitle;
+  GBitmap *icon;
+  SimpleMenuLayerSelectCallback callback;
+} SimpleMenuItem;
+
+typedef struct SimpleMenuSection
+{
+  const char *title;
+  const SimpleMenuItem *items;
+  uint32_t num_items;
+} SimpleMenuSection;
+
+//##################### Colors ##############################################
+
+#define GColorClear ((GColor8){.argb = 0x00})
+#define GColorBlack ((GColor8){.argb = GColorBlackARGB8})
+#define GColorWhite ((GColor8){.argb = GColorWhiteARGB8})
+
+#define GColorBlackARGB8 ((uint8_t)0xC0)
+#define GColorOxfordBlueARGB8 ((uint8_t)0xC1)
+#define GColorDukeBlueARGB8 ((uint8_t)0xC2)
+#define GColorBlueARGB8 ((uint8_t)0xC3)
+#define GColorDarkGreenARGB8 ((uint8_t)0xC4)
+#define GColorMidnightGreenARGB8 ((uint8_t)0xC5)
+#define GColorCobaltBlueARGB8 ((uint8_t)0xC6)
+#define GColorBlueMoonARGB8 ((uint8_t)0xC7)
+#define GColorIslamicGreenARGB8 ((uint8_t)0xC8)
+#define GColorJaegerGreenARGB8 ((uint8_t)0xC9)
+#define GColorTiffanyBlueARGB8 ((uint8_t)0xCA)
+#define GColorVividCeruleanARGB8 ((uint8_t)0xCB)
+#define GColorGreenARGB8 ((uint8_t)0xCC)
+#define GColorMalachiteARGB8 ((uint8_t)0xCD)
+#define GColorMediumSpringGreenARGB8 ((uint8_t)0xCE)
+#define GColorCyanARGB8 ((uint8_t)0xCF)
+#define GColorBulgarianRoseARGB8 ((uint8_t)0xD0)
+#define GColorImperialPurpleARGB8 ((uint8_t)0xD1)
+#define GColorIndigoARGB8 ((uint8_t)0xD2)
+#define GColorElectricUltramarineARGB8 ((uint8_t)0xD3)
+#define GColorArmyGreenARGB8 ((uint8_t)0xD4)
+#define GColorDarkGrayARGB8 ((uint8_t)0xD5)
+#define GColorLibertyARGB8 ((uint8_t)0xD6)
+#define GColorVeryLightBlueARGB8 ((uint8_t)0xD7)
+#define GColorKellyGreenARGB8 ((uint8_t)0xD8)
+#define GColorMayGreenARGB8 ((uint8_t)0xD9)
+#define GColorCadetBlueARGB8 ((uint8_t)0xDA)
+#define GColorPictonBlueARGB8 ((uint8_t)0xDB)
+#define GColorBrightGreenARGB8 ((uint8_t)0xDC)
+#define GColorScreaminGreenARGB8 ((uint8_t)0xDD)
+#define GColorMediumAquamarineARGB8 ((uint8_t)0xDE)
+#define GColorElectricBlueARGB8 ((uint8_t)0xDF)
+#define GColorDarkCandyAppleRedARGB8 ((uint8_t)0xE0)
+#define GColorJazzberryJamARGB8 ((uint8_t)0xE1)
+#define GColorPurpleARGB8 ((uint8_t)0xE2)
+#define GColorVividVioletARGB8 ((uint8_t)0xE3)
+#define GColorWindsorTanARGB8 ((uint8_t)0xE4)
+#define GColorRoseValeARGB8 ((uint8_t)0xE5)
+#define GColorPurpureusARGB8 ((uint8_t)0xE6)
+#define GColorLavenderIndigoARGB8 ((uint8_t)0xE7)
+#define GColorLimerickARGB8 ((uint8_t)0xE8)
+#define GColorBrassARGB8 ((uint8_t)0xE9)
+#define GColorLightGrayARGB8 ((uint8_t)0xEA)
+#define GColorBabyBlueEyesARGB8 ((uint8_t)0xEB)
+#define GColorSpringBudARGB8 ((uint8_t)0xEC)
+#define GColorInchwormARGB8 ((uint8_t)0xED)
+#define GColorMintGreenARGB8 ((uint8_t)0xEE)
+#define GColorCelesteARGB8 ((uint8_t)0xEF)
+#define GColorRedARGB8 ((uint8_t)0xF0)
+#define GColorFollyARGB8 ((uint8_t)0xF1)
+#define GColorFashionMagentaARGB8 ((uint8_t)0xF2)
+#define GColorMagentaARGB8 ((uint8_t)0xF3)
+#define GColorOrangeARGB8 ((uint8_t)0xF4)
+#define GColorSunsetOrangeARGB8 ((uint8_t)0xF5)
+#define GColorBrilliantRoseARGB8 ((uint8_t)0xF6)
+#define GColorShockingPinkARGB8 ((uint8_t)0xF7)
+#define GColorChromeYellowARGB8 ((uint8_t)0xF8)
+#define GColorRajahARGB8 ((uint8_t)0xF9)
+#define GColorMelonARGB8 ((uint8_t)0xFA)
+#define GColorRichBrilliantLavenderARGB8 ((uint8_t)0xFB)
+#define GColorYellowARGB8 ((uint8_t)0xFC)
+#define GColorIcterineARGB8 ((uint8_t)0xFD)
+#define GColorPastelYellowARGB8 ((uint8_t)0xFE)
+#define GColorWhiteARGB8 ((uint8_t)0xFF)
+
+//##################### Resources and fonts #################################
+
+// Resource ids, as generated by the SDK from appinfo.json.
+#define RESOURCE_ID_START_STOP 1
+#define RESOURCE_ID_LIGHT_ICON 2
+#define RESOURCE_ID_MENU_IMAGE 3
+#define RESOURCE_ID_DN_ICON 4
+#define RESOURCE_ID_UP_ICON 5
+#define RESOURCE_ID_FONT_UNIVERS_COND_MED_46 6
+#define RESOURCE_ID_FONT_UNIVERS_COND_MED_24 7
+
+#define FONT_KEY_GOTHIC_18_BOLD "RESOURCE_ID_GOTHIC_18_BOLD"
+#define FONT_KEY_GOTHIC_24_BOLD "RESOURCE_ID_GOTHIC_24_BOLD"
+#define FONT_KEY_BITHAM_42_BOLD "RESOURCE_ID_BITHAM_42_BOLD"
+
+ResHandle resource_get_handle(uint32_t resource_id);
+GFont fonts_load_custom_font(ResHandle handle);
+void fonts_unload_custom_font(GFont font);
+GFont fonts_get_system_font(const char *font_key);
+
+//##################### Bitmaps #############################################
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id);
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+GBitmap *gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format, GColor *palette, bool free_on_destroy);
+void gbitmap_destroy(GBitmap *bitmap);
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds);
+GColor *gbitmap_get_palette(const GBitmap *bitmap);
+
+//##################### Graphics ############################################
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box, GTextOverflowMode overflow_mode,
+                        GTextAlignment alignment, void *text_attributes);
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode, GTextAlignment alignment);
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+
+//##################### Layers ##############################################
+
+Layer *layer_create(GRect frame);
+Layer *layer_create_with_data(GRect frame, size_t data_size);
+void layer_destroy(Layer *layer);
+void *layer_get_data(const Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_mark_dirty(Layer *layer);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_set_hidden(Layer *layer, bool hidden);
+bool layer_get_hidden(const Layer *layer);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_frame(Layer *layer, GRect frame);
+GRect layer_get_bounds(const Layer *layer);
+
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+const char *text_layer_get_text(TextLayer *text_layer);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+
+BitmapLayer *bitmap_layer_create(GRect frame);
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer);
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer);
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap);
+void bitmap_layer_set_background_color(BitmapLayer *bitmap_layer, GColor color);
+
+SimpleMenuLayer *simple_menu_layer_create(GRect frame, Window *window, const SimpleMenuSection *sections,
+                                          int32_t num_sections, void *callback_context);
+void simple_menu_layer_destroy(SimpleMenuLayer *menu_layer);
+Layer *simple_menu_layer_get_layer(const SimpleMenuLayer *simple_menu);
+void simple_menu_layer_set_selected_index(SimpleMenuLayer *simple_menu, int32_t index, bool animated);
+
+//##################### Windows and buttons #################################
+
+Window *window_create(void);
+void window_destroy(Window *window);
+Layer *window_get_root_layer(const Window *window);
+void window_set_fullscreen(Window *window, bool enabled);
+void window_set_background_color(Window *window, GColor background_color);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider);
+bool window_is_loaded(Window *window);
+
+void window_stack_push(Window *window, bool animated);
+Window *window_stack_pop(bool animated);
+Window *window_stack_get_top_window(void);
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler);
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler,
+                                 ClickHandler up_handler);
+void window_raw_click_subscribe(ButtonId button_id, ClickHandler down_handler, ClickHandler up_handler,
+                                void *context);
+
+//##################### Time and timers #####################################
+
+// Wall clock time is simulated, see pebble_host.h. Calls to time() read the simulated clock.
+#define time(tloc) host_time(tloc)
+time_t host_time(time_t *tloc);
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+bool clock_is_24h_style(void);
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+void app_timer_cancel(AppTimer *timer_handle);
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+//##################### Persistent storage ##################################
+
+#define PERSIST_DATA_MAX_LENGTH 256
+
+bool persist_exists(const uint32_t key);
+int persist_get_size(const uint32_t key);
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size);
+int persist_write_data(const uint32_t key, const void *data, const size_t size);
+int32_t persist_read_int(const uint32_t key);
+int persist_write_int(const uint32_t key, const int32_t value);
+int persist_delete(const uint32_t key);
+
+//##################### App #################################################
+
+#define APP_LOG(level, fmt, ...) app_log(level, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...)
+  __attribute__((format(printf, 4, 5)));
+
+void app_event_loop(void);
@@ -0,0 +1,1431 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// Host stand-in for the Pebble SDK. See pebble.h and pebble_host.h.
+
+#include <stdarg.h>
+#include "pebble.h"
+#include "pebble_host.h"
+
+#define HOST_SCREEN_W 144
+#define HOST_SCREEN_H 168
+#define HOST_WINDOW_STACK_MAX 8
+#define HOST_PERSIST_KEYS 256
+
+
+//##################### Objects #############################################
+
+struct GFontInfo
+{
+  int16_t height;
+  bool custom; // Loaded by fonts_load_custom_font(), so freed when unloaded.
+};
+
+struct GBitmap
+{
+  uint8_t *data;
+  uint16_t rowSize;
+  GBitmapFormat format;
+  GSize size;
+  GRect bounds;
+  GColor *palette;
+  bool freePalette;
+};
+
+struct Layer
+{
+  GRect frame;
+  bool hidden;
+  LayerUpdateProc updateProc;
+  Layer *parent;
+  Layer *firstChild;
+  Layer *nextSibling;
+  void *data;  // layer_create_with_data().
+  void *owner; // Text, bitmap or menu layer this layer belongs to.
+};
+
+struct TextLayer
+{
+  Layer *layer;
+  const char *text;
+  GFont font;
+  GTextAlignment alignment;
+  GColor textColor;
+  GColor backgroundColor;
+};
+
+struct BitmapLayer
+{
+  Layer *layer;
+  const GBitmap *bitmap;
+  GColor backgroundColor;
+};
+
+struct SimpleMenuLayer
+{
+  Layer *layer;
+  const SimpleMenuSection *sections;
+  int32_t selected;
+};
+
+struct Window
+{
+  Layer *root;
+  WindowHandlers handlers;
+  ClickConfigProvider clickConfigProvider;
+  GColor backgroundColor;
+  bool loaded;
+};
+
+struct GContext
+{
+  GPoint offset; // Screen position of the layer being drawn.
+  GRect clip;    // Screen area the layer may draw in.
+  GColor fillColor;
+  GColor textColor;
+  GCompOp compositingMode;
+};
+
+struct AppTimer
+{
+  int64_t fireMs;
+  AppTimerCallback callback;
+  void *data;
+  AppTimer *next;
+};
+
+// Click handlers subscribed by the top window's click config provider.
+typedef struct host_click_S
+{
+  ClickHandler single;
+  ClickHandler longDown;
+  ClickHandler longUp;
+  uint16_t longDelayMs;
+  ClickHandler rawDown;
+  ClickHandler rawUp;
+} host_click_S;
+
+typedef struct host_persist_S
+{
+  uint32_t key;
+  uint16_t len;
+  bool used;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} host_persist_S;
+
+static int64_t nowMs = 0;
+static bool is24hStyle = false;
+static bool logEnabled = false;
+
+static Window *windowStack[HOST_WINDOW_STACK_MAX];
+static int windowCnt = 0;
+static host_click_S clicks[NUM_BUTTONS];
+
+static bool renderPending = false;
+static GBitmap *frameBuffer = NULL;
+static struct GContext context;
+
+static AppTimer *timers = NULL; // Earliest first.
+static TickHandler tickHandler = NULL;
+static TimeUnits tickUnits = 0;
+
+static host_persist_S persistKeys[HOST_PERSIST_KEYS];
+
+static struct GFontInfo systemFonts[] = {{.height = 18}, {.height = 24}, {.height = 42}};
+
+
+//##################### Log #################################################
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...)
+{
+  if ( ! logEnabled)
+  {
+    return;
+  }
+
+  va_list args;
+  va_start(args, fmt);
+  fprintf(stderr, "%s:%i ", src_filename, src_line_number);
+  vfprintf(stderr, fmt, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+}
+
+
+void host_log_enable(bool enabled)
+{
+  logEnabled = enabled;
+}
+
+
+//##################### Resources and fonts #################################
+
+ResHandle resource_get_handle(uint32_t resource_id)
+{
+  return (ResHandle)(uintptr_t)resource_id;
+}
+
+
+GFont fonts_load_custom_font(ResHandle handle)
+{
+  struct GFontInfo *font = malloc(sizeof(struct GFontInfo));
+  if (font != NULL)
+  {
+    font->height = ((uintptr_t)handle == RESOURCE_ID_FONT_UNIVERS_COND_MED_46) ? 46 : 24;
+    font->custom = true;
+  }
+  return font;
+}
+
+
+void fonts_unload_custom_font(GFont font)
+{
+  if (font != NULL && font->custom)
+  {
+    free(font);
+  }
+}
+
+
+GFont fonts_get_system_font(const char *font_key)
+{
+  if (strstr(font_key, "18") != NULL)
+  {
+    return &systemFonts[0];
+  }
+  return (strstr(font_key, "42") != NULL) ? &systemFonts[2] : &systemFonts[1];
+}
+
+
+// Width of one character. Digits and letters are half as wide as the font is high.
+static int host_char_width(GFont font, char c)
+{
+  if (c == ':' || c == '.')
+  {
+    return font->height / 5;
+  }
+  return (c == ' ') ? font->height / 4 : font->height / 2;
+}
+
+
+//##################### Bitmaps #############################################
+
+static GBitmap *host_bitmap_create(GSize size, GBitmapFormat format)
+{
+  GBitmap *bitmap = calloc(1, sizeof(GBitmap));
+  if (bitmap == NULL)
+  {
+    return NULL;
+  }
+
+  // Black and white rows are whole 32 bit words, as on the watch.
+  bitmap->rowSize = (format == GBitmapFormat8Bit) ? size.w
+                  : (format == GBitmapFormat1Bit) ? ((size.w + 31) / 32) * 4
+                  : (size.w + 7) / 8;
+  bitmap->format = format;
+  bitmap->size = size;
+  bitmap->bounds = GRect(0, 0, size.w, size.h);
+  bitmap->data = calloc(bitmap->rowSize, size.h);
+  if (bitmap->data == NULL)
+  {
+    free(bitmap);
+    return NULL;
+  }
+
+  return bitmap;
+}
+
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id)
+{
+  return host_bitmap_create(GSize(15, 15), GBitmapFormat1Bit);
+}
+
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format)
+{
+  return host_bitmap_create(size, format);
+}
+
+
+GBitmap *gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format, GColor *palette, bool free_on_destroy)
+{
+  GBitmap *bitmap = host_bitmap_create(size, format);
+  if (bitmap != NULL)
+  {
+    bitmap->palette = palette;
+    bitmap->freePalette = free_on_destroy;
+  }
+  return bitmap;
+}
+
+
+void gbitmap_destroy(GBitmap *bitmap)
+{
+  if (bitmap == NULL)
+  {
+    return;
+  }
+
+  if (bitmap->freePalette)
+  {
+    free(bitmap->palette);
+  }
+  free(bitmap->data);
+  free(bitmap);
+}
+
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap)
+{
+  return bitmap->data;
+}
+
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap)
+{
+  return bitmap->rowSize;
+}
+
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap)
+{
+  return bitmap->format;
+}
+
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap)
+{
+  return bitmap->bounds;
+}
+
+
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds)
+{
+  bitmap->bounds = bounds;
+}
+
+
+GColor *gbitmap_get_palette(const GBitmap *bitmap)
+{
+  return bitmap->palette;
+}
+
+
+// Color of pixel "x", "y" of "bitmap". Clear where nothing is to be drawn.
+static GColor host_bitmap_pixel(const GBitmap *bitmap, int x, int y)
+{
+  const uint8_t *row = bitmap->data + y * bitmap->rowSize;
+
+  if (bitmap->format == GBitmapFormat8Bit)
+  {
+    return (GColor8){.argb = row[x]};
+  }
+  if (bitmap->format == GBitmapFormat1BitPalette)
+  {
+    // Palettized: most significant bit is leftmost.
+    return bitmap->palette[(row[x / 8] >> (7 - x % 8)) & 1];
+  }
+
+  // Least significant bit is leftmost. Set bits are white.
+  return ((row[x / 8] >> (x % 8)) & 1) ? GColorWhite : GColorBlack;
+}
+
+
+//##################### Frame buffer and graphics ###########################
+
+static GBitmap *host_frame_buffer()
+{
+  if (frameBuffer == NULL)
+  {
+    #ifdef PBL_COLOR
+    frameBuffer = host_bitmap_create(GSize(HOST_SCREEN_W, HOST_SCREEN_H), GBitmapFormat8Bit);
+    #else
+    frameBuffer = host_bitmap_create(GSize(HOST_SCREEN_W, HOST_SCREEN_H), GBitmapFormat1Bit);
+    #endif
+  }
+  return frameBuffer;
+}
+
+
+// Set screen pixel "x", "y" if within the clip. Black and white screens show any color other
+// than white as black.
+static void host_set_pixel(int x, int y, GColor color)
+{
+  if (x < context.clip.origin.x || x >= context.clip.origin.x + context.clip.size.w ||
+      y < context.clip.origin.y || y >= context.clip.origin.y + context.clip.size.h ||
+      color.a == 0)
+  {
+    return;
+  }
+
+  uint8_t *row = frameBuffer->data + y * frameBuffer->rowSize;
+  #ifdef PBL_COLOR
+  row[x] = color.argb;
+  #else
+  if (gcolor_equal(color, GColorWhite))
+  {
+    row[x / 8] |= 1 << (x % 8);
+  }
+  else
+  {
+    row[x / 8] &= ~(1 << (x % 8));
+  }
+  #endif
+}
+
+
+static void host_fill_screen_rect(GRect rect, GColor color)
+{
+  for (int y = rect.origin.y; y < rect.origin.y + rect.size.h; y++)
+  {
+    for (int x = rect.origin.x; x < rect.origin.x + rect.size.w; x++)
+    {
+      host_set_pixel(x, y, color);
+    }
+  }
+}
+
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color)
+{
+  ctx->fillColor = color;
+}
+
+
+void graphics_context_set_text_color(GContext *ctx, GColor color)
+{
+  ctx->textColor = color;
+}
+
+
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode)
+{
+  ctx->compositingMode = mode;
+}
+
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask)
+{
+  rect.origin.x += ctx->offset.x;
+  rect.origin.y += ctx->offset.y;
+  host_fill_screen_rect(rect, ctx->fillColor);
+}
+
+
+// The bitmap's bounds are drawn at the top left of "rect", not tiled.
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect)
+{
+  GRect bounds = bitmap->bounds;
+  for (int y = 0; y < bounds.size.h && y < rect.size.h; y++)
+  {
+    for (int x = 0; x < bounds.size.w && x < rect.size.w; x++)
+    {
+      GColor color = host_bitmap_pixel(bitmap, bounds.origin.x + x, bounds.origin.y + y);
+      if (bitmap->format == GBitmapFormat1Bit && ctx->compositingMode == GCompOpAssignInverted)
+      {
+        color = gcolor_equal(color, GColorWhite) ? GColorBlack : GColorWhite;
+      }
+      host_set_pixel(ctx->offset.x + rect.origin.x + x, ctx->offset.y + rect.origin.y + y, color);
+    }
+  }
+}
+
+
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode, GTextAlignment alignment)
+{
+  int width = 0;
+  for (const char *c = text; *c != '\0'; c++)
+  {
+    width += host_char_width(font, *c);
+  }
+
+  return GSize(width < box.size.w ? width : box.size.w, font->height);
+}
+
+
+// Each character is drawn as a solid block of its width, on one line.
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box, GTextOverflowMode overflow_mode,
+                        GTextAlignment alignment, void *text_attributes)
+{
+  GSize size = graphics_text_layout_get_content_size(text, font, box, overflow_mode, alignment);
+  int x = box.origin.x + ((alignment == GTextAlignmentRight) ? box.size.w - size.w
+                        : (alignment == GTextAlignmentCenter) ? (box.size.w - size.w) / 2 : 0);
+
+  for (const char *c = text; *c != '\0'; c++)
+  {
+    int width = host_char_width(font, *c);
+    if (*c != ' ')
+    {
+      host_fill_screen_rect(GRect(ctx->offset.x + x + 1, ctx->offset.y + box.origin.y + font->height / 5,
+                                  width - 2, font->height * 3 / 5),
+                            ctx->textColor);
+    }
+    x += width;
+  }
+}
+
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx)
+{
+  return host_frame_buffer();
+}
+
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer)
+{
+  return true;
+}
+
+
+//##################### Layers ##############################################
+
+Layer *layer_create(GRect frame)
+{
+  Layer *layer = calloc(1, sizeof(Layer));
+  if (layer != NULL)
+  {
+    layer->frame = frame;
+  }
+  return layer;
+}
+
+
+Layer *layer_create_with_data(GRect frame, size_t data_size)
+{
+  Layer *layer = layer_create(frame);
+  if (layer != NULL && (layer->data = calloc(1, data_size)) == NULL)
+  {
+    free(layer);
+    return NULL;
+  }
+  return layer;
+}
+
+
+static void layer_remove_from_parent(Layer *layer)
+{
+  if (layer->parent == NULL)
+  {
+    return;
+  }
+
+  Layer **link = &layer->parent->firstChild;
+  while (*link != layer)
+  {
+    link = &(*link)->nextSibling;
+  }
+  *link = layer->nextSibling;
+
+  layer->parent = NULL;
+  layer->nextSibling = NULL;
+}
+
+
+// Children of a destroyed layer are left without a parent, as on the watch.
+void layer_destroy(Layer *layer)
+{
+  if (layer == NULL)
+  {
+    return;
+  }
+
+  layer_remove_from_parent(layer);
+  while (layer->firstChild != NULL)
+  {
+    layer_remove_from_parent(layer->firstChild);
+  }
+
+  free(layer->data);
+  free(layer);
+  renderPending = true;
+}
+
+
+void *layer_get_data(const Layer *layer)
+{
+  return layer->data;
+}
+
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc)
+{
+  layer->updateProc = update_proc;
+}
+
+
+// The watch redraws the whole window whenever any layer is dirty.
+void layer_mark_dirty(Layer *layer)
+{
+  renderPending = true;
+}
+
+
+// Children are drawn after, so above, earlier children.
+void layer_add_child(Layer *parent, Layer *child)
+{
+  layer_remove_from_parent(child);
+
+  Layer **link = &parent->firstChild;
+  while (*link != NULL)
+  {
+    link = &(*link)->nextSibling;
+  }
+  *link = child;
+  child->parent = parent;
+  renderPending = true;
+}
+
+
+void layer_set_hidden(Layer *layer, bool hidden)
+{
+  if (layer->hidden != hidden)
+  {
+    layer->hidden = hidden;
+    renderPending = true;
+  }
+}
+
+
+bool layer_get_hidden(const Layer *layer)
+{
+  return layer->hidden;
+}
+
+
+GRect layer_get_frame(const Layer *layer)
+{
+  return layer->frame;
+}
+
+
+void layer_set_frame(Layer *layer, GRect frame)
+{
+  layer->frame = frame;
+  renderPending = true;
+}
+
+
+GRect layer_get_bounds(const Layer *layer)
+{
+  return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+
+// ### Text layer ###
+
+static void text_layer_update_proc(Layer *layer, GContext *ctx)
+{
+  TextLayer *text_layer = layer->owner;
+
+  graphics_context_set_fill_color(ctx, text_layer->backgroundColor);
+  graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
+
+  if (text_layer->text != NULL)
+  {
+    graphics_context_set_text_color(ctx, text_layer->textColor);
+    graphics_draw_text(ctx, text_layer->text, text_layer->font, layer_get_bounds(layer),
+                       GTextOverflowModeWordWrap, text_layer->alignment, NULL);
+  }
+}
+
+
+TextLayer *text_layer_create(GRect frame)
+{
+  TextLayer *text_layer = calloc(1, sizeof(TextLayer));
+  if (text_layer == NULL || (text_layer->layer = layer_create(frame)) == NULL)
+  {
+    free(text_layer);
+    return NULL;
+  }
+
+  text_layer->layer->owner = text_layer;
+  text_layer->layer->updateProc = text_layer_update_proc;
+  text_layer->font = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+  text_layer->textColor = GColorBlack;
+  text_layer->backgroundColor = GColorWhite;
+  return text_layer;
+}
+
+
+void text_layer_destroy(TextLayer *text_layer)
+{
+  layer_destroy(text_layer->layer);
+  free(text_layer);
+}
+
+
+Layer *text_layer_get_layer(TextLayer *text_layer)
+{
+  return text_layer->layer;
+}
+
+
+void text_layer_set_text(TextLayer *text_layer, const char *text)
+{
+  text_layer->text = text;
+  renderPending = true;
+}
+
+
+const char *text_layer_get_text(TextLayer *text_layer)
+{
+  return text_layer->text;
+}
+
+
+void text_layer_set_font(TextLayer *text_layer, GFont font)
+{
+  text_layer->font = font;
+  renderPending = true;
+}
+
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment)
+{
+  text_layer->alignment = text_alignment;
+  renderPending = true;
+}
+
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color)
+{
+  text_layer->textColor = color;
+  renderPending = true;
+}
+
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color)
+{
+  text_layer->backgroundColor = color;
+  renderPending = true;
+}
+
+
+// ### Bitmap layer ###
+
+static void bitmap_layer_update_proc(Layer *layer, GContext *ctx)
+{
+  BitmapLayer *bitmap_layer = layer->owner;
+
+  graphics_context_set_fill_color(ctx, bitmap_layer->backgroundColor);
+  graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
+
+  if (bitmap_layer->bitmap != NULL)
+  {
+    graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+    graphics_draw_bitmap_in_rect(ctx, bitmap_layer->bitmap, layer_get_bounds(layer));
+  }
+}
+
+
+BitmapLayer *bitmap_layer_create(GRect frame)
+{
+  BitmapLayer *bitmap_layer = calloc(1, sizeof(BitmapLayer));
+  if (bitmap_layer == NULL || (bitmap_layer->layer = layer_create(frame)) == NULL)
+  {
+    free(bitmap_layer);
+    return NULL;
+  }
+
+  bitmap_layer->layer->owner = bitmap_layer;
+  bitmap_layer->layer->updateProc = bitmap_layer_update_proc;
+  bitmap_layer->backgroundColor = GColorClear;
+  return bitmap_layer;
+}
+
+
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer)
+{
+  layer_destroy(bitmap_layer->layer);
+  free(bitmap_layer);
+}
+
+
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer)
+{
+  return bitmap_layer->layer;
+}
+
+
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap)
+{
+  bitmap_layer->bitmap = bitmap;
+  renderPending = true;
+}
+
+
+void bitmap_layer_set_background_color(BitmapLayer *bitmap_layer, GColor color)
+{
+  bitmap_layer->backgroundColor = color;
+  renderPending = true;
+}
+
+
+// ### Simple menu layer ###
+
+SimpleMenuLayer *simple_menu_layer_create(GRect frame, Window *window, const SimpleMenuSection *sections,
+                                          int32_t num_sections, void *callback_context)
+{
+  SimpleMenuLayer *menu_layer = calloc(1, sizeof(SimpleMenuLayer));
+  if (menu_layer == NULL || (menu_layer->layer = layer_create(frame)) == NULL)
+  {
+    free(menu_layer);
+    return NULL;
+  }
+
+  menu_layer->layer->owner = menu_layer;
+  menu_layer->sections = sections;
+  return menu_layer;
+}
+
+
+void simple_menu_layer_destroy(SimpleMenuLayer *menu_layer)
+{
+  layer_destroy(menu_layer->layer);
+  free(menu_layer);
+}
+
+
+Layer *simple_menu_layer_get_layer(const SimpleMenuLayer *simple_menu)
+{
+  return simple_menu->layer;
+}
+
+
+void simple_menu_layer_set_selected_index(SimpleMenuLayer *simple_menu, int32_t index, bool animated)
+{
+  simple_menu->selected = index;
+}
+
+
+//##################### Rendering ###########################################
+
+static void host_render_layer(Layer *layer, GPoint parentOffset, GRect parentClip)
+{
+  if (layer->hidden)
+  {
+    return;
+  }
+
+  GPoint offset = GPoint(parentOffset.x + layer->frame.origin.x, parentOffset.y + layer->frame.origin.y);
+
+  // Clip to the layer's frame within its parent's clip.
+  int left = (offset.x > parentClip.origin.x) ? offset.x : parentClip.origin.x;
+  int top = (offset.y > parentClip.origin.y) ? offset.y : parentClip.origin.y;
+  int right = offset.x + layer->frame.size.w;
+  int bottom = offset.y + layer->frame.size.h;
+  if (right > parentClip.origin.x + parentClip.size.w)
+  {
+    right = parentClip.origin.x + parentClip.size.w;
+  }
+  if (bottom > parentClip.origin.y + parentClip.size.h)
+  {
+    bottom = parentClip.origin.y + parentClip.size.h;
+  }
+  GRect clip = GRect(left, top, right > left ? right - left : 0, bottom > top ? bottom - top : 0);
+
+  if (layer->updateProc != NULL)
+  {
+    context = (struct GContext){.offset = offset, .clip = clip, .fillColor = GColorBlack,
+                                .textColor = GColorBlack, .compositingMode = GCompOpAssign};
+    layer->updateProc(layer, &context);
+  }
+
+  for (Layer *child = layer->firstChild; child != NULL; child = child->nextSibling)
+  {
+    host_render_layer(child, offset, clip);
+  }
+}
+
+
+bool host_render()
+{
+  if ( ! renderPending || windowCnt == 0)
+  {
+    return false;
+  }
+  renderPending = false;
+
+  Window *window = windowStack[windowCnt - 1];
+  host_frame_buffer();
+  context.clip = GRect(0, 0, HOST_SCREEN_W, HOST_SCREEN_H);
+  host_fill_screen_rect(context.clip, window->backgroundColor);
+  host_render_layer(window->root, GPoint(0, 0), context.clip);
+  return true;
+}
+
+
+//##################### Windows and buttons #################################
+
+Window *window_create(void)
+{
+  Window *window = calloc(1, sizeof(Window));
+  if (window == NULL || (window->root = layer_create(GRect(0, 0, HOST_SCREEN_W, HOST_SCREEN_H))) == NULL)
+  {
+    free(window);
+    return NULL;
+  }
+
+  window->backgroundColor = GColorWhite;
+  return window;
+}
+
+
+Layer *window_get_root_layer(const Window *window)
+{
+  return window->root;
+}
+
+
+void window_set_fullscreen(Window *window, bool enabled)
+{
+}
+
+
+void window_set_background_color(Window *window, GColor background_color)
+{
+  window->backgroundColor = background_color;
+  renderPending = true;
+}
+
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers)
+{
+  window->handlers = handlers;
+}
+
+
+void window_set_click_config_provider(Window *window, ClickConfigProvider click_config_provider)
+{
+  window->clickConfigProvider = click_config_provider;
+}
+
+
+bool window_is_loaded(Window *window)
+{
+  return window->loaded;
+}
+
+
+Window *window_stack_get_top_window(void)
+{
+  return (windowCnt > 0) ? windowStack[windowCnt - 1] : NULL;
+}
+
+
+// The top window appears and takes the buttons.
+static void host_window_appear(Window *window)
+{
+  memset(clicks, 0, sizeof(clicks));
+  if (window->clickConfigProvider != NULL)
+  {
+    window->clickConfigProvider(window);
+  }
+
+  if (window->handlers.appear != NULL)
+  {
+    window->handlers.appear(window);
+  }
+  renderPending = true;
+}
+
+
+void window_stack_push(Window *window, bool animated)
+{
+  if (windowCnt == HOST_WINDOW_STACK_MAX)
+  {
+    return;
+  }
+
+  Window *covered = window_stack_get_top_window();
+  if (covered != NULL && covered->handlers.disappear != NULL)
+  {
+    covered->handlers.disappear(covered);
+  }
+
+  windowStack[windowCnt++] = window;
+  if ( ! window->loaded)
+  {
+    window->loaded = true;
+    if (window->handlers.load != NULL)
+    {
+      window->handlers.load(window);
+    }
+  }
+
+  host_window_appear(window);
+}
+
+
+// Remove "window" from the stack, unloading it. The window below appears if it was on top.
+static void host_window_remove(Window *window)
+{
+  int index = windowCnt - 1;
+  while (index >= 0 && windowStack[index] != window)
+  {
+    index--;
+  }
+  if (index < 0)
+  {
+    return;
+  }
+
+  bool wasTop = (index == windowCnt - 1);
+  if (wasTop && window->handlers.disappear != NULL)
+  {
+    window->handlers.disappear(window);
+  }
+
+  memmove(&windowStack[index], &windowStack[index + 1], (windowCnt - index - 1) * sizeof(Window *));
+  windowCnt--;
+
+  window->loaded = false;
+  if (window->handlers.unload != NULL)
+  {
+    window->handlers.unload(window);
+  }
+
+  if (wasTop && windowCnt > 0)
+  {
+    host_window_appear(windowStack[windowCnt - 1]);
+  }
+}
+
+
+Window *window_stack_pop(bool animated)
+{
+  Window *window = window_stack_get_top_window();
+  if (window != NULL)
+  {
+    host_window_remove(window);
+  }
+  return window;
+}
+
+
+// A window still on the stack is removed and unloaded first.
+void window_destroy(Window *window)
+{
+  if (window == NULL)
+  {
+    return;
+  }
+
+  host_window_remove(window);
+  layer_destroy(window->root);
+  free(window);
+}
+
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler)
+{
+  clicks[button_id].single = handler;
+}
+
+
+void window_long_click_subscribe(ButtonId button_id, uint16_t delay_ms, ClickHandler down_handler,
+                                 ClickHandler up_handler)
+{
+  clicks[button_id].longDown = down_handler;
+  clicks[button_id].longUp = up_handler;
+  clicks[button_id].longDelayMs = delay_ms;
+}
+
+
+void window_raw_click_subscribe(ButtonId button_id, ClickHandler down_handler, ClickHandler up_handler,
+                                void *context)
+{
+  clicks[button_id].rawDown = down_handler;
+  clicks[button_id].rawUp = up_handler;
+}
+
+
+// Call a click handler of the top window, then catch up as the event loop would.
+static void host_click_handler(ClickHandler handler)
+{
+  if (handler != NULL)
+  {
+    handler(NULL, window_stack_get_top_window());
+  }
+}
+
+
+void host_hold(ButtonId button, int64_t holdMs)
+{
+  // Handlers may change the top window and its subscriptions.
+  host_click_S click = clicks[button];
+
+  host_click_handler(click.rawDown);
+  host_advance_ms(0);
+
+  bool isLong = click.longDown != NULL && holdMs >= click.longDelayMs;
+  if (isLong)
+  {
+    host_advance_ms(click.longDelayMs);
+    host_click_handler(click.longDown);
+    holdMs -= click.longDelayMs;
+  }
+  host_advance_ms(holdMs);
+
+  host_click_handler(click.rawUp);
+  host_click_handler(isLong ? click.longUp : click.single);
+  host_advance_ms(0);
+}
+
+
+void host_click(ButtonId button)
+{
+  host_hold(button, 0);
+}
+
+
+//##################### Time and timers #####################################
+
+void host_clock_set_ms(int64_t ms)
+{
+  nowMs = ms;
+}
+
+
+int64_t host_clock_ms()
+{
+  return nowMs;
+}
+
+
+void host_set_24h_style(bool is24h)
+{
+  is24hStyle = is24h;
+}
+
+
+time_t host_time(time_t *tloc)
+{
+  time_t sec = nowMs / 1000;
+  if (tloc != NULL)
+  {
+    *tloc = sec;
+  }
+  return sec;
+}
+
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms)
+{
+  uint16_t ms = nowMs % 1000;
+  host_time(tloc);
+  if (out_ms != NULL)
+  {
+    *out_ms = ms;
+  }
+  return ms;
+}
+
+
+bool clock_is_24h_style(void)
+{
+  return is24hStyle;
+}
+
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data)
+{
+  AppTimer *timer = malloc(sizeof(AppTimer));
+  if (timer == NULL)
+  {
+    return NULL;
+  }
+
+  *timer = (AppTimer){.fireMs = nowMs + timeout_ms, .callback = callback, .data = callback_data};
+
+  // Timers due at the same time fire in the order registered.
+  AppTimer **link = &timers;
+  while (*link != NULL && (*link)->fireMs <= timer->fireMs)
+  {
+    link = &(*link)->next;
+  }
+  timer->next = *link;
+  *link = timer;
+  return timer;
+}
+
+
+// Cancelling a timer that already fired does nothing.
+void app_timer_cancel(AppTimer *timer_handle)
+{
+  for (AppTimer **link = &timers; *link != NULL; link = &(*link)->next)
+  {
+    if (*link == timer_handle)
+    {
+      *link = timer_handle->next;
+      free(timer_handle);
+      return;
+    }
+  }
+}
+
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler)
+{
+  tickUnits = tick_units;
+  tickHandler = handler;
+}
+
+
+void tick_timer_service_unsubscribe(void)
+{
+  tickUnits = 0;
+  tickHandler = NULL;
+}
+
+
+// Units that changed from second "prevSec" to "sec".
+static TimeUnits host_units_changed(time_t prevSec, time_t sec)
+{
+  struct tm prev = *localtime(&prevSec);
+  struct tm now = *localtime(&sec);
+
+  return SECOND_UNIT |
+         (prev.tm_min != now.tm_min ? MINUTE_UNIT : 0) |
+         (prev.tm_hour != now.tm_hour ? HOUR_UNIT : 0) |
+         (prev.tm_mday != now.tm_mday ? DAY_UNIT : 0) |
+         (prev.tm_mon != now.tm_mon ? MONTH_UNIT : 0) |
+         (prev.tm_year != now.tm_year ? YEAR_UNIT : 0);
+}
+
+
+void host_advance_ms(int64_t ms)
+{
+  int64_t endMs = nowMs + ms;
+
+  while (true)
+  {
+    int64_t tickMs = (tickHandler != NULL) ? (nowMs / 1000 + 1) * 1000 : endMs + 1;
+    AppTimer *timer = timers;
+
+    if (timer != NULL && timer->fireMs <= endMs && timer->fireMs <= tickMs)
+    {
+      if (timer->fireMs > nowMs)
+      {
+        nowMs = timer->fireMs;
+      }
+      timers = timer->next;
+      AppTimer fired = *timer;
+      free(timer);
+      fired.callback(fired.data);
+    }
+    else if (tickMs <= endMs)
+    {
+      TimeUnits changed = host_units_changed(nowMs / 1000, tickMs / 1000);
+      nowMs = tickMs;
+      if (changed & tickUnits)
+      {
+        time_t sec = nowMs / 1000;
+        tickHandler(localtime(&sec), changed);
+      }
+    }
+    else
+    {
+      break;
+    }
+
+    host_render();
+  }
+
+  nowMs = endMs;
+  host_render();
+}
+
+
+void app_event_loop(void)
+{
+  host_render();
+}
+
+
+//##################### Persistent storage ##################################
+
+static host_persist_S *host_persist_find(uint32_t key)
+{
+  for (int i = 0; i < HOST_PERSIST_KEYS; i++)
+  {
+    if (persistKeys[i].used && persistKeys[i].key == key)
+    {
+      return &persistKeys[i];
+    }
+  }
+  return NULL;
+}
+
+
+int host_persist_used_bytes()
+{
+  int bytes = 0;
+  for (int i = 0; i < HOST_PERSIST_KEYS; i++)
+  {
+    bytes += persistKeys[i].used ? persistKeys[i].len : 0;
+  }
+  return bytes;
+}
+
+
+bool persist_exists(const uint32_t key)
+{
+  return host_persist_find(key) != NULL;
+}
+
+
+int persist_get_size(const uint32_t key)
+{
+  host_persist_S *entry = host_persist_find(key);
+  return (entry != NULL) ? entry->len : E_DOES_NOT_EXIST;
+}
+
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size)
+{
+  host_persist_S *entry = host_persist_find(key);
+  if (entry == NULL)
+  {
+    return E_DOES_NOT_EXIST;
+  }
+
+  int len = (entry->len < buffer_size) ? entry->len : (int)buffer_size;
+  memcpy(buffer, entry->data, len);
+  return len;
+}
+
+
+// Values longer than PERSIST_DATA_MAX_LENGTH are cut short. Fails if the store would exceed
+// HOST_PERSIST_QUOTA.
+int persist_write_data(const uint32_t key, const void *data, const size_t size)
+{
+  int len = (size < PERSIST_DATA_MAX_LENGTH) ? (int)size : PERSIST_DATA_MAX_LENGTH;
+  host_persist_S *entry = host_persist_find(key);
+
+  if (host_persist_used_bytes() - (entry != NULL ? entry->len : 0) + len > HOST_PERSIST_QUOTA)
+  {
+    return E_OUT_OF_STORAGE;
+  }
+
+  for (int i = 0; entry == NULL && i < HOST_PERSIST_KEYS; i++)
+  {
+    if ( ! persistKeys[i].used)
+    {
+      entry = &persistKeys[i];
+    }
+  }
+  if (entry == NULL)
+  {
+    return E_OUT_OF_STORAGE;
+  }
+
+  entry->used = true;
+  entry->key = key;
+  entry->len = len;
+  memcpy(entry->data, data, len);
+  return len;
+}
+
+
+int32_t persist_read_int(const uint32_t key)
+{
+  int32_t value = 0;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+
+
+int persist_write_int(const uint32_t key, const int32_t value)
+{
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+
+int persist_delete(const uint32_t key)
+{
+  host_persist_S *entry = host_persist_find(key);
+  if (entry == NULL)
+  {
+    return E_DOES_NOT_EXIST;
+  }
+
+  entry->used = false;
+  return S_SUCCESS;
+}
+
+
+void host_persist_clear()
+{
+  memset(persistKeys, 0, sizeof(persistKeys));
+}
+
+
+// File is a sequence of key (4 bytes), length (2 bytes) and value, in host byte order.
+bool host_persist_load(const char *path)
+{
+  host_persist_clear();
+
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+  {
+    return true;
+  }
+
+  uint32_t key;
+  uint16_t len;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+  bool ok = true;
+  while (ok && fread(&key, sizeof(key), 1, file) == 1)
+  {
+    ok = fread(&len, sizeof(len), 1, file) == 1 && len <= PERSIST_DATA_MAX_LENGTH &&
+         fread(data, 1, len, file) == len && persist_write_data(key, data, len) == len;
+  }
+
+  fclose(file);
+  return ok;
+}
+
+
+bool host_persist_save(const char *path)
+{
+  FILE *file = fopen(path, "wb");
+  if (file == NULL)
+  {
+    return false;
+  }
+
+  bool ok = true;
+  for (int i = 0; i < HOST_PERSIST_KEYS; i++)
+  {
+    if (persistKeys[i].used)
+    {
+      ok = ok && fwrite(&persistKeys[i].key, sizeof(uint32_t), 1, file) == 1 &&
+                 fwrite(&persistKeys[i].len, sizeof(uint16_t), 1, file) == 1 &&
+                 fwrite(persistKeys[i].data, 1, persistKeys[i].len, file) == persistKeys[i].len;
+    }
+  }
+
+  return fclose(file) == 0 && ok;
+}
+
+
+//##################### Teardown ############################################
+
+void host_reset()
+{
+  while (windowCnt > 0)
+  {
+    window_stack_pop(false);
+  }
+
+  while (timers != NULL)
+  {
+    app_timer_cancel(timers);
+  }
+  tick_timer_service_unsubscribe();
+
+  gbitmap_destroy(frameBuffer);
+  frameBuffer = NULL;
+  renderPending = false;
+}
@@ -0,0 +1,56 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// Controls of the host stand-in for the Pebble SDK (pebble.h), used by the benchmarks to drive
+// the app as the watch would: a simulated wall clock, timers and ticks fired as the clock is
+// advanced, button presses on the top window, rendering of the top window when a layer was
+// marked dirty, and a persistent store limited to the watch's per-app quota.
+
+#pragma once
+
+#include "pebble.h"
+
+// Persistent storage per app on the watch. Writes that would exceed it fail.
+#define HOST_PERSIST_QUOTA 4096
+
+// ### Clock, timers and ticks ###
+
+void host_clock_set_ms(int64_t nowMs);
+int64_t host_clock_ms();
+void host_set_24h_style(bool is24h);
+
+// Advance the clock by "ms", firing app timers and ticks in time order as they fall due, and
+// rendering after each as the event loop does. Timers due now are fired with an "ms" of zero.
+void host_advance_ms(int64_t ms);
+
+// ### Buttons ###
+
+// Press and release "button" on the top window: raw down, raw up, then the single click.
+void host_click(ButtonId button);
+
+// Press "button", hold it for "holdMs" while time passes, then release. A long click fires if
+// one is subscribed and the hold reached its delay; otherwise the release is a single click.
+void host_hold(ButtonId button, int64_t holdMs);
+
+// ### Rendering ###
+
+// Render the top window if any layer was marked dirty since the last render. Returns whether
+// it rendered. Drawing goes to a frame buffer of the platform's format.
+bool host_render();
+
+// ### Persistent storage ###
+
+// Load the store from, or save it to, "path". The store starts empty if the file does not exist.
+bool host_persist_load(const char *path);
+bool host_persist_save(const char *path);
+void host_persist_clear();
+int host_persist_used_bytes();
+
+// ### Log ###
+
+// APP_LOG output goes to stderr when enabled. Off by default.
+void host_log_enable(bool enabled);
+
+// ### Teardown ###
+
+// Release what the app left behind after app_deinit(): windows still on the stack, timers and
+// the frame buffer. Only needed between repeated app_init()/app_deinit() runs.
+void host_reset();
@@ -14,34 +14,44 @@
 
 // Standard includes
 #include "pebble.h"
+#include "chrono.h"
+#include "settings.h"
+#include "palette.h"
+#include "digit_layer.h"
 
 // Forward declarations.
-void format_splits_content();
 void setup_splits_window();
 void select_splits_display_content();
 static void tc_set_color();
-
-// Menu window is pushed to the stack first, then the time window below it.
+static void tc_update_redraw_rate();
+static void tc_handle_second_tick(struct tm *currentTime, TimeUnits units_changed);
+static void tc_show_chrono();
+static void tc_show_clock_now();
+static void tc_update_spt_rst_label();
+static void split_window_push();
+static bool clear_splits_ready();
+static void clear_splits_action();
+static void option_colors_changed(SettingId setting);
+static int session_store_make_room(int liveBytes, int bytes, bool needSlot);
+static bool session_store_evict_all();
+
+// Only the time window is created at launch. The others are created on first push, and
+// their layers and graphics only exist while they are on the window stack.
 static Window *option_window; 
 static Window *menu_window; 
 static Window *split_window; 
+static Window *session_window; 
 static Window *time_window; 
 
-// Menu window layers and associated data.
-#ifdef PBL_COLOR
-#define NBR_MENU_ITEMS 7
-#else
-#define NBR_MENU_ITEMS 6
-#endif
+// Menu window layers. Menu items are with the option table.
 static SimpleMenuLayer *menuLayer;
-static SimpleMenuItem menuItems[NBR_MENU_ITEMS];
-static SimpleMenuSection menuSection[1];
 
 // Time/chronometer window layers.
 static BitmapLayer *lightLayer;
 static TextLayer *modeButtonLayer;
-static TextLayer *timeChronoHhmmLayer;
-static TextLayer *timeChronoSecLayer;
+static Layer *timeChronoHhmmLayer; // Digit layers, see digit_layer.h.
+static Layer *timeChronoSecLayer;
+static Layer *timeChronoFracLayer;
 static BitmapLayer *ssLayer;
 static TextLayer *dateInfoLayer;
 static TextLayer *sptRstButtonLayer;
@@ -53,6 +63,10 @@ static BitmapLayer *splitUpIconLayer;
 static TextLayer *splitContentLayer;
 static BitmapLayer *splitDnIconLayer;
 
+// Session browser window layers. Its menu items are allocated while it is loaded.
+static SimpleMenuLayer *sessionMenuLayer;
+static SimpleMenuSection sessionSection[1];
+
 // Option window layers.
 static TextLayer *optionUpLabelLayer;
 static TextLayer *optionContentLayer;
@@ -64,152 +78,271 @@ static TextLayer *optionDownLabelLayer;
 #define MODE_MAX 2
 static short selectedMode = MODE_CLOCK;
 
-// Start/Stop select
-#define RUN_START 0
-#define RUN_STOP 1
-#define RUN_MAX 2
-static short chronoRunSelect = RUN_STOP;
-
-// Fonts for time and chronometer.
-GFont hhmm_font;
-GFont sec_font;
-
-// Graphics
-GBitmap* menuIcon;
-GBitmap *up_image;
-GBitmap *dn_image;
-static GPath *startIconP = NULL;
-static GPath *stopIconP = NULL;
-static const GPathInfo STOP_PATH_INFO = {
-  .num_points = 4,
-  .points = (GPoint []) {{0, 8}, {13, 8}, {13, 21}, {0, 21}}
-};
-static const GPathInfo START_PATH_INFO = {
-  .num_points = 3,
-  .points = (GPoint []) {{0, 8}, {12, 15}, {0, 22}}
-};
+// Time and chronometer are drawn from glyph atlases captured from their fonts, which are then
+// unloaded. Only the date keeps a font.
+#define HHMM_GLYPHS "0123456789:HOLD"
+#define SEC_GLYPHS "0123456789."
+static digit_atlas_S *hhmmAtlas;
+static digit_atlas_S *secAtlas;
+GFont date_font;
+
+// Graphics. Loaded with the window using them.
+GBitmap* menuIcon;  // Menu window.
+GBitmap *up_image;  // Splits window.
+GBitmap *dn_image;  // Splits window.
+
+// Start/stop and light icons. Drawn pixel by pixel into bitmaps once per color scheme,
+// so their layers only blit. 1 bit per pixel on black and white, GColor8 pixels on color.
+#define SS_ICON_SIZE GSize(14, 30)
+#define LIGHT_ICON_SIZE GSize(16, 16)
+static GBitmap *startIcon = NULL;
+static GBitmap *stopIcon = NULL;
+static GBitmap *lightIcon = NULL;
 
 // SDK 3.0 support for color option
 GColor colorDark;
+static bool tcColorStale = true; // Time window colors need setting from the color settings.
 
-// Time chronometer was started, or zero if reset.
-static time_t chronoElapsed = 0;
+// Chronometer tenths are redrawn by a timer, but only while they can be seen changing.
+#define FAST_REDRAW_MS 100
+static AppTimer *fastRedrawTimerHandle = NULL;
+static char chronoFracText[] = ".0";
+static bool timeWindowVisible = false;
 
-// Time or chronograph value as text string.
+// Tick units currently subscribed, or NO_TICK_UNITS. Ticks are only taken while a
+// display that changes once per second is on screen.
+#define NO_TICK_UNITS ((TimeUnits)0)
+static TimeUnits tickUnits = NO_TICK_UNITS;
+
+// Time or chronograph value as text strings, hours/minutes and seconds.
+// Each is only reformatted, and its layer dirtied, when its value changes.
 #define MAX_TIME_TEXT_LEN 9
-static char timeText[] = "00:00:00";
+#define TIME_FIELD_UNKNOWN -1
+static char hhmmText[] = " 0:00";
+static char secText[] = "00";
+static int shownHhmm = TIME_FIELD_UNKNOWN; // hours * 100 + minutes currently displayed.
+static int shownSec = TIME_FIELD_UNKNOWN;  // Seconds currently displayed.
 
 // Month day or "CHRONO".
 // 2.1.1 static char dateStr[] = "Jan 31"; 
 static char dateStr[] = "Wednesday/nSep 30"; 
 
-// Saved chrono time during wait for reset.
-static char savedChronoHhmm[] = "00:00";
-static char savedChronoSec[] = "00"; 
-static time_t savedChronoElapsed = 0;
+// Reset hold in progress. Chrono time is replaced by "HOLD" until the reset completes or is aborted.
 static bool resetInProgress = false;
 static AppTimer *resetTimerHandle = NULL;
 
+// Wall clock time (ms) DOWN was pressed while the chronometer ran, or zero. The split is taken
+// as of the press once the click is recognized, not when the recognizer fires after release.
+#define SPLIT_PRESS_NONE 0
+static int64_t splitPressMs = SPLIT_PRESS_NONE;
+
+// Start/stop and split presses are queued with their times and applied just after the button
+// handler returns, so a burst of presses is never merged and the display catches up afterwards.
+static AppTimer *inputDrainTimerHandle = NULL;
+
 // 12/24 hour clock. Access once and remember.
 static bool clock_is_24h = false;
 
-// "true" if the chronometer has been reset after being stopped.
-// (i.e. do not need to display RESET text on a stopped and reset chronometer)
-static bool chronoHasBeenReset = true;
-
-// Split/reset button text.
-#define SPLIT_TEXT_MAX_LEN 11
-static char BLANK_TEXT[] = "";
-static char OPTIONS_TEXT[] = "Options";
-static char RESET_TEXT[] = "Reset";
-static char SPLIT_TEXT[] = "Split";     // Will be appended with next available split number.
-static char SPLIT_TEXT_FULL[] = "Split Full";
-static char spt_rstButtonText[SPLIT_TEXT_MAX_LEN] = ""; // Space for "Split Full" w/ null terminator
-
-// Splits. Earliest first. Split format " 1) 12:34:56" plus newline/null.
-#define SPLIT_INDEX_RESET -1
-#define MAX_SPLIT_INDEX 98
+// Split/reset button label. Derived from the mode and chronometer state, and only set on
+// its layer when it changes. The next split number is written in place into splitNbrText.
+typedef enum
+{
+  SPT_RST_UNKNOWN,
+  SPT_RST_BLANK,
+  SPT_RST_OPTIONS,
+  SPT_RST_RESET,
+  SPT_RST_SPLIT,      // "Split N"
+  SPT_RST_SPLIT_FULL,
+  SPT_RST_MAX
+} SptRstLabel;
+
+#define SPLIT_TEXT_MAX_LEN 11 // Label length saved before PERSIST_VERSION_TLV.
+#define SPLIT_NBR_OFFSET 6
+#define SPLIT_NBR_DIGITS 5
+static char splitNbrText[] = "Split 00000"; // Room for SPLIT_NBR_DIGITS digits.
+static const char *SPT_RST_LABEL_TEXT[SPT_RST_MAX] = {[SPT_RST_UNKNOWN] = "",
+                                                      [SPT_RST_BLANK] = "",
+                                                      [SPT_RST_OPTIONS] = "Options",
+                                                      [SPT_RST_RESET] = "Reset",
+                                                      [SPT_RST_SPLIT] = splitNbrText,
+                                                      [SPT_RST_SPLIT_FULL] = "Split Full"};
+static SptRstLabel shownSptRstLabel = SPT_RST_UNKNOWN;
+static int shownSplitNbr = 0;
+
+// Splits display. Split format "  1)  1:23:45" plus newline/null. Page text is allocated
+// while the splits window is loaded, and is NULL otherwise.
 #define MAX_DISPLAY_SPLITS 5
-#define CHARS_PER_SPLIT 13
-static time_t splits[MAX_SPLIT_INDEX + 1];
-static int splitIndex = SPLIT_INDEX_RESET;
-static char formattedSplits[(MAX_SPLIT_INDEX + 1) * CHARS_PER_SPLIT];
-static char splitsDisplayContent[MAX_DISPLAY_SPLITS * CHARS_PER_SPLIT + 1]; // Extra char needed for \0.
-static char SPLITS_DISPLAY_NONE[] = "    None    "; // Must be CHARS_PER_SPLIT including NULL.
+#define CHARS_PER_SPLIT 14
+#define SPLITS_CONTENT_LEN (MAX_DISPLAY_SPLITS * CHARS_PER_SPLIT)
+static char *splitsDisplayContent = NULL; // Last row newline replaced by \0.
+static char SPLITS_DISPLAY_NONE[] = "     None    "; // Must be CHARS_PER_SPLIT including NULL.
 static int splitDisplayIndex = 0;
 
+// SELECT toggles the splits window between cumulative splits and laps. Laps are preceded
+// by a page of lap statistics, so in laps mode display index MAX_DISPLAY_SPLITS is lap 1.
+static bool splitsShowLaps = false;
+
+// Splits window shows the chronometer's splits, or those of the saved session in slot splitsSession.
+#define SPLITS_SESSION_NONE -1
+static int splitsSession = SPLITS_SESSION_NONE;
+static lap_stats_S sessionLapStats;
+#define LAP_STATS_ROWS 4
+#define LAP_STAT_LABEL_LEN 5
+static const char *LAP_STAT_LABEL[LAP_STATS_ROWS] = {"Fast ", "Slow ", "Mean ", "Avg5 "}; // Avg of LAP_ROLLING_CNT.
+
 // Support for option window.
 #define OPTION_CHOICE_YES "Yes"
 #define OPTION_CHOICE_NO "No"
-#define OPTION_CHOICE_MAX_LEN 4
+#define OPTION_CHOICE_MAX_LEN 4 // Choice length saved before PERSIST_VERSION_TLV.
 #define OPTION_TEXT_MAX_LEN 256
-static char optionText[OPTION_TEXT_MAX_LEN]; // Made global as a convenience, not required.
+static char *optionText = NULL; // Allocated while the option window is loaded.
 
-// Support for Clear Splits.
-static char clearSplitsText[] = "Select 'Yes' to clear splits.";
-static char splitsClearedText[] = "Splits have been cleared.";
-static char noSplitsText[] = "There are no splits.";
+// Options, in menu order. Each is a menu item and is edited in the one option window, which
+// works from the option's type. New options only need a row here.
+typedef enum
+{
+  OPTION_TYPE_ACTION, // UP does the action, when ready.
+  OPTION_TYPE_YES_NO, // UP sets Yes, DOWN sets No.
+  OPTION_TYPE_COLOR,  // UP/DOWN step through the palette, long press by group. Color platforms only.
+} OptionType;
 
-// Support for Reset behavior option.
-static char resetOptionText[] = "Chronometer Reset button also clears splits:";
-static char resetButtonClearsSplits[OPTION_CHOICE_MAX_LEN] = OPTION_CHOICE_YES;
+typedef struct option_S
+{
+  const char *title;              // Menu item.
+  OptionType type;
+  const char *prompt;             // Shown before a Yes/No choice, or to confirm an action.
+  SettingId setting;              // Yes/No and color options.
+  SettingsChangeHandler changed;  // Yes/No and color options, after a change. May be NULL.
+  bool (*ready)();                // Actions. False if there is nothing to do.
+  void (*action)();               // Actions.
+  const char *idleText;           // Actions, when not ready.
+  const char *doneText;           // Actions, once done.
+} option_S;
+
+static const option_S optionTable[] = {
+  {.title = "Clear Splits", .type = OPTION_TYPE_ACTION,
+   .prompt = "Select 'Yes' to clear splits.",
+   .ready = clear_splits_ready, .action = clear_splits_action,
+   .idleText = "There are no splits.", .doneText = "Splits have been cleared."},
+  {.title = "Splits Option", .type = OPTION_TYPE_YES_NO,
+   .prompt = "When splits memory is Full, replace oldest with new:", .setting = SETTING_REPLACE_OLDEST},
+  {.title = "Reset Option", .type = OPTION_TYPE_YES_NO,
+   .prompt = "Chronometer Reset button also clears splits:", .setting = SETTING_RESET_CLEARS_SPLITS},
+  {.title = "Color Inversion", .type = OPTION_TYPE_YES_NO,
+   .prompt = "Display time and chrono with white text on dark background:", .setting = SETTING_COLOR_INVERSION,
+   .changed = option_colors_changed},
+  #ifdef PBL_COLOR
+  {.title = "Color Select", .type = OPTION_TYPE_COLOR,
+   .setting = SETTING_COLOR_SELECT, .changed = option_colors_changed},
+  #endif
+};
+#define OPTION_COUNT ((int)(sizeof(optionTable) / sizeof(optionTable[0])))
 
-// Support for Split behavior option.
-static char splitsOptionText[] = "When splits memory is Full, replace oldest with new:";
-static char splitsFullReplaceOldest[OPTION_CHOICE_MAX_LEN] = OPTION_CHOICE_NO;
+static const option_S *optionShown = NULL; // Option in the option window.
 
-// Support for Color inversion.
-static char colorInversionText[] = "Display time and chrono with white text on dark background:";
-static char colorInversionChoice[OPTION_CHOICE_MAX_LEN] = OPTION_CHOICE_NO;
+// Menu items: Display Splits, Saved Sessions, the options, then the version.
+#define MENU_FIRST_OPTION 2
+#define NBR_MENU_ITEMS (MENU_FIRST_OPTION + OPTION_COUNT + 1)
+static SimpleMenuItem menuItems[NBR_MENU_ITEMS];
+static SimpleMenuSection menuSection[1];
 
-// Support for Color selection.
-#ifdef PBL_COLOR
-#define MIN_COLOR_SELECTION_OFFSET 0
-#define MAX_COLOR_SELECTION_OFFSET 15
-static int colorSelectChoice = 7;  // Blue
-static char * colorSelectText[MAX_COLOR_SELECTION_OFFSET + 1] = 
-  {"Black",
-   "Red",
-   "Light Red",
-   "Dark Red",
-   "Orange",
-   "Light Orange",
-   "Dark Orange",
-   "Blue",
-   "Light Blue",
-   "Dark Blue",
-   "Green",
-   "Light Green",
-   "Dark Green",
-   "Purple",
-   "Light Purple",
-   "Dark Purple"};
-static GColor colorSelectColor[MAX_COLOR_SELECTION_OFFSET + 1];
-#endif
+// Support for Color selection. Colors and their names are in the palette table.
+// Long press UP/DOWN jumps to the previous/next group of colors.
+#define COLOR_GROUP_LONG_CLICK_MS 500
   
 // Keys to access persistent data.
 static const uint32_t  persistent_data_key = 1;
 static const uint32_t  extended_splits_key = 2;
-
-// Divide splits between two sets of persistent data so do not exceed 256 byte max size.
-// Sum of BASE and EXTENDED must equal (MAX_SPLIT_INDEX + 1).
+static const uint32_t  persist_version_key = 3;
+static const uint32_t  chrono_journal_key = 4;
+static const uint32_t  journal_base_seq_key = 5; // Read only, now STATE_TAG_JOURNAL_BASE_SEQ.
+static const uint32_t  state_key = 6;
+static const uint32_t  session_index_key = 7;
+
+// Version of the persistent data. Data without a version key predates millisecond
+// resolution and holds chronometer and split times in seconds.
+#define PERSIST_VERSION_SECONDS 1
+#define PERSIST_VERSION_MS 2
+#define PERSIST_VERSION_SPLIT_STREAM 3
+#define PERSIST_VERSION_TLV 4
+#define PERSIST_VERSION PERSIST_VERSION_TLV
+
+// State is saved at state_key as a list of tag, length, value fields. Unknown tags are
+// skipped and missing tags keep their defaults, so fields can be added, or values lengthened,
+// without a new version. Multi-byte values are little endian.
+#define STATE_TAG_MODE 1   // selectedMode: 1 byte.
+#define STATE_TAG_CHRONO 2 // chronoRunSelect: 1 byte, elapsed ms at anchor: 4 bytes, anchor seconds: 4 bytes.
+#define STATE_TAG_FLAGS 3  // STATE_FLAG_ bits: 1 byte.
+#define STATE_TAG_COLOR 4  // Color select index into the original 16 colors: 1 byte. Read only.
+#define STATE_TAG_COLOR_ARGB8 5 // Dark color for SETTING_COLOR_SELECT, GColor8: 1 byte. Color platforms only.
+#define STATE_TAG_RUN_START 6 // Wall clock seconds of the run's first start, zero if not started: 4 bytes.
+#define STATE_TAG_SELECTED_CHRONO 7 // Chronometer on screen: 1 byte.
+#define STATE_TAG_SPLITS_BEFORE 9 // Split before the earliest saved, zero if none: 4 bytes.
+#define STATE_TAG_SPLITS_DROPPED 10 // Splits replaced when full before the earliest saved: 4 bytes.
+#define STATE_TAG_LAP_STATS 11 // Lap count, fastest, slowest and total since the splits were cleared: 16 bytes.
+#define STATE_LAP_STATS_LEN 16
+#define STATE_TAG_JOURNAL_BASE_SEQ 12 // Sequence number of the latest journaled split the saved splits hold: 4 bytes.
+
+// The fields above hold the first chronometer. Each of the others is one field of: index 1 byte,
+// run select 1 byte, elapsed ms at anchor 4 bytes, anchor seconds 4 bytes, STATE_FLAG_ bits 1 byte,
+// run start seconds 4 bytes, split before the earliest saved 4 bytes, splits replaced when full
+// before the earliest saved 4 bytes, lap statistics as STATE_TAG_LAP_STATS 16 bytes. Fields saved
+// without the splits replaced are read as none replaced, and without lap statistics rebuild them
+// from the splits.
+#define STATE_TAG_OTHER_CHRONO 8
+#define STATE_OTHER_CHRONO_MIN_LEN 19
+#define STATE_OTHER_CHRONO_DROPPED_LEN 23
+#define STATE_OTHER_CHRONO_LEN (STATE_OTHER_CHRONO_DROPPED_LEN + STATE_LAP_STATS_LEN)
+
+#define STATE_FLAG_CHRONO_RESET 0x01
+#define STATE_FLAG_RESET_CLEARS_SPLITS 0x02
+#define STATE_FLAG_REPLACE_OLDEST 0x04
+#define STATE_FLAG_COLOR_INVERSION 0x08
+
+// Before PERSIST_VERSION_SPLIT_STREAM, up to 99 splits were divided between the base and
+// extended sets of persistent data so as not to exceed the 256 byte max size.
 #define BASE_SPLIT_CNT 46
 #define EXTENDED_SPLIT_CNT 53
 
-// Structure to save state when app is not running.
+// Splits are now saved as a byte stream divided across as many keys as needed, beginning
+// at SPLIT_STREAM_FIRST_KEY. Stream is the format byte, the split count, then each split
+// as its difference from the previous split (the first from zero). Count and differences
+// are varints, and differences are zigzag encoded as splits restart at zero after a reset
+// that keeps splits. Typical differences take 3 bytes instead of 4.
+#define SPLIT_STREAM_FIRST_KEY 20
+#define SPLIT_STREAM_MAX_KEYS 10 // Room for MAX_SPLITS worst case 5 byte varints.
+#define SPLIT_STREAM_FORMAT 1
+
+// The splits of each other chronometer are saved in one key from OTHER_SPLITS_FIRST_KEY, so they
+// fit beside the first chronometer's splits and the session store. All OTHER_MAX_SPLITS splits a
+// ring holds fit one key as worst case 5 byte varints.
+#define OTHER_SPLITS_FIRST_KEY 40
+
+typedef struct split_stream_S
+{
+  uint8_t buf[PERSIST_DATA_MAX_LENGTH];
+  int len;      // Bytes in buf. Writing: bytes to write. Reading: bytes read from key.
+  int pos;      // Reading: next byte in buf.
+  uint32_t key;    // Next key to write or read.
+  uint32_t endKey; // One past the last key the stream may use.
+  bool ok;         // No write or read error so far.
+} split_stream_S;
+
+// Structure of the state saved before PERSIST_VERSION_TLV. Read only to migrate it.
+// Its size differs between platforms, so it is only read on the platform that wrote it.
 typedef struct saved_state_S
 {
   short selectedMode;
   char timeText [MAX_TIME_TEXT_LEN];
   char dateStr [17];
   short chronoRunSelect;
-  time_t chronoElapsed;
+  uint32_t chronoElapsed;
   time_t closeTm;
   char spt_rstButtonText[SPLIT_TEXT_MAX_LEN];
   bool chronoHasBeenReset;
   char colorInversionChoice[OPTION_CHOICE_MAX_LEN];
-  time_t splits[BASE_SPLIT_CNT];
-  int splitIndex;
+  uint32_t splits[BASE_SPLIT_CNT]; // Unused from PERSIST_VERSION_SPLIT_STREAM.
+  int splitIndex;                  // Unused from PERSIST_VERSION_SPLIT_STREAM.
   char resetButtonClearsSplits[OPTION_CHOICE_MAX_LEN];
   char splitsFullReplaceOldest[OPTION_CHOICE_MAX_LEN];
   #ifdef PBL_COLOR
@@ -218,577 +351,2170 @@ typedef struct saved_state_S
 } __attribute__((__packed__)) saved_state_S;
 
 
-// Structure to save extended splits
+// Structure to save extended splits. Before PERSIST_VERSION_SPLIT_STREAM only.
 typedef struct saved_splits_S
 {
-  time_t splits[EXTENDED_SPLIT_CNT];
+  uint32_t splits[EXTENDED_SPLIT_CNT];
 } __attribute__((__packed__)) saved_splits_S;
 
+// Journal. Saved state and splits are only rewritten when compacting: on exit, after
+// SPLIT_JOURNAL_MAX splits, or when splits are cleared. In between, each split and each
+// chronometer run state change is written as a small record so they survive an abnormal exit.
+#define SPLIT_JOURNAL_FIRST_KEY 100
+#define SPLIT_JOURNAL_MAX 16
 
+// Journaled split. "seq" is the split's sequence number, one more than the previous split's,
+// whichever chronometer took them. Records written before there were several chronometers
+// end before "chrono" and belong to the first.
+typedef struct journal_split_S
+{
+  uint32_t splitMs;
+  uint32_t seq;
+  uint8_t chrono;
+} __attribute__((__packed__)) journal_split_S;
 
+#define JOURNAL_SPLIT_LEN_FIRST_CHRONO (sizeof(journal_split_S) - 1)
 
-//##################### Option window support ################################
+// Journaled chronometer run state, at chrono_journal_key for the first chronometer and from
+// OTHER_CHRONO_JOURNAL_FIRST_KEY for the others. Chronometer had chronoElapsed at anchorTm.
+#define OTHER_CHRONO_JOURNAL_FIRST_KEY 50
+typedef struct journal_chrono_S
+{
+  short chronoRunSelect;
+  uint32_t chronoElapsed;
+  time_t anchorTm;
+  bool chronoHasBeenReset;
+} __attribute__((__packed__)) journal_chrono_S;
+
+static uint32_t splitSeq = 0;     // Sequence number of the latest split.
+static uint32_t baseSplitSeq = 0; // Sequence number of the latest split in the saved state and splits.
+
+// Session store. Splits about to be cleared by Reset or Clear Splits are first archived as a
+// session. The index at session_index_key describes every session and is all that is read at
+// launch. Each session's splits are a split stream in its own SESSION_KEYS keys, read only when
+// the session is opened. Sessions only use the persistent storage the live state leaves: least
+// recently used sessions are evicted whenever the live state needs more.
+#define SESSION_MAX 8
+#define SESSION_FIRST_KEY 200
+#define SESSION_KEYS 2
+#define SESSION_MAX_SPLITS 100 // Latest splits archived. Worst case 5 byte varints fit SESSION_KEYS.
+#define SESSION_INDEX_FORMAT 2
+
+// Persistent storage of the app, shared by the live state and the session store.
+#define PERSIST_QUOTA_BYTES 4096
+
+typedef struct session_S
+{
+  uint32_t startTm;  // Wall clock seconds of the run's first start. Zero if the slot is free.
+  uint32_t totalMs;  // Chronometer elapsed ms when archived.
+  uint16_t splitCnt; // Splits archived.
+  uint16_t bytes;    // Split stream bytes.
+  uint32_t lastUse;  // Index useSeq when archived or last opened.
+  uint32_t beforeMs; // Split before the first archived, which its lap is measured from. Zero if none.
+  uint32_t dropped;  // Splits of the run before the first archived, which is numbered one more.
+} __attribute__((__packed__)) session_S;
+
+typedef struct session_index_S
+{
+  uint8_t format;
+  uint32_t useSeq;
+  session_S sessions[SESSION_MAX];
+} __attribute__((__packed__)) session_index_S;
 
-// ### Clear splits support ###
+static session_index_S sessionIndex;
 
-// Clear splits UP button - do it!
-static void clear_splits_up_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
 
-  strcpy(formattedSplits, SPLITS_DISPLAY_NONE);
 
-  // Clear splits.
-  splitIndex = -1;
-  splitDisplayIndex = 0;
-  select_splits_display_content();
 
-  // If the chronometer is running and was the last thing displayed before
-  // navigation to Clear splits, need to label Splits button for split 1.
-  if (selectedMode == MODE_CHRON && chronoRunSelect == RUN_START)
+//##################### Persistence support ################################
+
+// Delete split stream keys from "key" up to "endKey".
+static void split_stream_delete(uint32_t key, uint32_t endKey)
+{
+  for ( ; key < endKey; key++)
   {
-    snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s %i", SPLIT_TEXT, splitIndex + 2);
+    persist_delete(key);
   }
-
-  layer_set_hidden(bitmap_layer_get_layer(splitUpIconLayer), true);
-  layer_set_hidden(bitmap_layer_get_layer(splitDnIconLayer), true);
-
-  // Update option window to reflect action.
-  text_layer_set_text(optionContentLayer, splitsClearedText);
-}
-
-
-// Clear splits click configuration.
-static void clear_splits_click_config_provider(Window *window) {
-
-  window_single_click_subscribe(BUTTON_ID_UP, (ClickHandler) clear_splits_up_single_click_handler);
 }
 
-// ### Splits option support ###
-
-// Splits option UP button - save latest.
-static void splits_option_up_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
 
-  // Save choice for Split button use.
-  strncpy(splitsFullReplaceOldest, OPTION_CHOICE_YES, sizeof(splitsFullReplaceOldest));
-
-  // Update option window to reflect choice.
-  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s %s", splitsOptionText, splitsFullReplaceOldest);
-  text_layer_set_text(optionContentLayer, optionText);
-
-  // If split/reset button currently indicates Full, change to last split slot number.
-  if (strcmp(spt_rstButtonText, SPLIT_TEXT_FULL) == 0)
+// Write buffered stream bytes to the next key.
+static void split_stream_flush(split_stream_S *stream)
+{
+  if (stream->len > 0)
   {
-    snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s %i", SPLIT_TEXT, MAX_SPLIT_INDEX + 1);
-    text_layer_set_text(sptRstButtonLayer, spt_rstButtonText);
+    if (stream->key >= stream->endKey ||
+        stream->len != persist_write_data(stream->key, (void *)stream->buf, stream->len))
+    {
+      stream->ok = false;
+    }
+
+    stream->key++;
+    stream->len = 0;
   }
 }
 
 
-// Splits option DOWN button - save oldest.
-static void splits_option_down_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+static void split_stream_put_varint(split_stream_S *stream, uint32_t value)
+{
+  do
+  {
+    if (stream->len == PERSIST_DATA_MAX_LENGTH)
+    {
+      split_stream_flush(stream);
+    }
 
-  // Save choice for Split button use.
-  strncpy(splitsFullReplaceOldest, OPTION_CHOICE_NO, sizeof(splitsFullReplaceOldest));
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    stream->buf[stream->len++] = value ? (byte | 0x80) : byte;
+  } while (value);
+}
 
-  // Update option window to reflect choice.
-  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s %s", splitsOptionText, splitsFullReplaceOldest);
-  text_layer_set_text(optionContentLayer, optionText);
 
-  // If split/reset button currently indicates last split slot number, change to indicate Full.
-  char testStr[SPLIT_TEXT_MAX_LEN];
-  snprintf(testStr, SPLIT_TEXT_MAX_LEN, "%s %i", SPLIT_TEXT, MAX_SPLIT_INDEX + 1);
-  if (strcmp(spt_rstButtonText, testStr) == 0)
+static int split_stream_varint_len(uint32_t value)
+{
+  int len = 1;
+  while (value >>= 7)
   {
-    snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s", SPLIT_TEXT_FULL);
-    text_layer_set_text(sptRstButtonLayer, spt_rstButtonText);
+    len++;
   }
+  return len;
 }
 
 
-// Splits option click configuration.
-static void splits_option_click_config_provider(Window *window) {
+// Read the next varint. Reads the next key when the current one is used up.
+static uint32_t split_stream_get_varint(split_stream_S *stream)
+{
+  uint32_t value = 0;
+  for (int shift = 0; stream->ok && shift < 35; shift += 7)
+  {
+    if (stream->pos == stream->len)
+    {
+      stream->len = (stream->key < stream->endKey)
+                    ? persist_read_data(stream->key++, (void *)stream->buf, sizeof(stream->buf)) : 0;
+      stream->pos = 0;
+      if (stream->len <= 0)
+      {
+        stream->ok = false;
+        break;
+      }
+    }
 
-  window_single_click_subscribe(BUTTON_ID_UP, (ClickHandler) splits_option_up_single_click_handler);
+    uint8_t byte = stream->buf[stream->pos++];
+    value |= (uint32_t)(byte & 0x7F) << shift;
+    if ( ! (byte & 0x80))
+    {
+      return value;
+    }
+  }
 
-  window_single_click_subscribe(BUTTON_ID_DOWN, (ClickHandler) splits_option_down_single_click_handler);
+  stream->ok = false;
+  return 0;
 }
 
-// ### Reset option support ###
-
-// Reset option UP button.
-static void reset_option_up_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
 
-  // Save choice for Reset button use.
-  strncpy(resetButtonClearsSplits, OPTION_CHOICE_YES, sizeof(resetButtonClearsSplits));
-
-  // Update option window to reflect choice.
-  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s %s", resetOptionText, resetButtonClearsSplits);
-  text_layer_set_text(optionContentLayer, optionText);
+// Split as a zigzag encoded difference from the previous split.
+static uint32_t split_stream_zigzag(uint32_t prevMs, uint32_t splitMs)
+{
+  int32_t diff = (int32_t)(splitMs - prevMs);
+  return ((uint32_t)diff << 1) ^ (uint32_t)(diff >> 31);
 }
 
 
-// Reset option DOWN button.
-static void reset_option_down_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
-
-  // Save choice for Reset button use.
-  strncpy(resetButtonClearsSplits, OPTION_CHOICE_NO, sizeof(resetButtonClearsSplits));
+// Save the chronometer's splits from logical "index" on as a split stream in keys "firstKey"
+// up to "endKey". Keys left from a longer stream are deleted.
+static bool split_stream_save(uint32_t firstKey, uint32_t endKey, int index)
+{
+  split_stream_S stream = {.len = 0, .pos = 0, .key = firstKey, .endKey = endKey, .ok = true};
 
-  // Update option window to reflect choice.
-  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s %s", resetOptionText, resetButtonClearsSplits);
-  text_layer_set_text(optionContentLayer, optionText);
-}
+  split_stream_put_varint(&stream, SPLIT_STREAM_FORMAT);
+  split_stream_put_varint(&stream, split_ring_count(chrono_splits()) - index);
 
+  split_ring_iter_S iter = split_ring_iter(chrono_splits(), index);
+  uint32_t splitMs;
+  uint32_t prevMs = 0;
+  while (split_ring_next(&iter, &splitMs))
+  {
+    split_stream_put_varint(&stream, split_stream_zigzag(prevMs, splitMs));
+    prevMs = splitMs;
+  }
 
-// Reset option click configuration.
-static void reset_option_click_config_provider(Window *window) {
+  split_stream_flush(&stream);
 
-  window_single_click_subscribe(BUTTON_ID_UP, (ClickHandler) reset_option_up_single_click_handler);
+  // Drop keys left from a longer stream.
+  split_stream_delete(stream.key, endKey);
 
-  window_single_click_subscribe(BUTTON_ID_DOWN, (ClickHandler) reset_option_down_single_click_handler);
+  return stream.ok;
 }
 
-// ### Color inversion support ###
-
-// Color inversion UP button.
-static void color_inversion_up_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
 
-  // Save choice.
-  strncpy(colorInversionChoice, OPTION_CHOICE_YES, sizeof(colorInversionChoice));
+// Bytes split_stream_save() writes for the same splits.
+static int split_stream_size(int index)
+{
+  int size = split_stream_varint_len(SPLIT_STREAM_FORMAT) +
+             split_stream_varint_len(split_ring_count(chrono_splits()) - index);
 
-  // Update option window to reflect choice.
-  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s %s", colorInversionText, colorInversionChoice);
-  text_layer_set_text(optionContentLayer, optionText);
+  split_ring_iter_S iter = split_ring_iter(chrono_splits(), index);
+  uint32_t splitMs;
+  uint32_t prevMs = 0;
+  while (split_ring_next(&iter, &splitMs))
+  {
+    size += split_stream_varint_len(split_stream_zigzag(prevMs, splitMs));
+    prevMs = splitMs;
+  }
 
-  // tc_set_color() will be called by the time/chrono .appear window handler.
+  return size;
 }
 
 
-// Color inversion DOWN button.
-static void color_inversion_down_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
-
-  // Save choice.
-  strncpy(colorInversionChoice, OPTION_CHOICE_NO, sizeof(colorInversionChoice));
+// Begin reading a split stream in keys "firstKey" up to "endKey". Returns the split count,
+// or -1 if there is no split stream there.
+static int split_stream_open(split_stream_S *stream, uint32_t firstKey, uint32_t endKey)
+{
+  *stream = (split_stream_S){.len = 0, .pos = 0, .key = firstKey, .endKey = endKey, .ok = true};
 
-  // Update option window to reflect choice.
-  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s %s", colorInversionText, colorInversionChoice);
-  text_layer_set_text(optionContentLayer, optionText);
+  if (split_stream_get_varint(stream) != SPLIT_STREAM_FORMAT)
+  {
+    return -1;
+  }
 
-  // tc_set_color() will be called by the time/chrono .appear window handler.
+  uint32_t splitCnt = split_stream_get_varint(stream);
+  return stream->ok ? (int)splitCnt : -1;
 }
 
 
-// Color inversion click configuration.
-static void color_inversion_click_config_provider(Window *window) {
-
-  window_single_click_subscribe(BUTTON_ID_UP, (ClickHandler) color_inversion_up_single_click_handler);
-
-  window_single_click_subscribe(BUTTON_ID_DOWN, (ClickHandler) color_inversion_down_single_click_handler);
+// Read the next split. "splitMs" holds the previous split, or zero before the first.
+static void split_stream_next(split_stream_S *stream, uint32_t *splitMs)
+{
+  uint32_t zigzag = split_stream_get_varint(stream);
+  *splitMs += (zigzag >> 1) ^ -(zigzag & 1);
 }
 
 
-// ### Color select support ###
-
-#ifdef PBL_COLOR
-static void color_select_set_choice()
+// Split before logical "index" of the selected chronometer, which the lap ending at "index"
+// is measured from. Zero if none.
+static uint32_t persist_split_before(int index)
 {
-  // Adjust DOWN/UP button text.
-  if (colorSelectChoice >= MAX_COLOR_SELECTION_OFFSET)
-  {
-    //layer_set_hidden(text_layer_get_layer(optionUpLabelLayer), false);
-    //layer_set_hidden(text_layer_get_layer(optionDownLabelLayer), true);
-    text_layer_set_text(optionUpLabelLayer, "Prev");
-    text_layer_set_text(optionDownLabelLayer, "");
-  }
-  else if (colorSelectChoice <= MIN_COLOR_SELECTION_OFFSET)
-  {
-    //layer_set_hidden(text_layer_get_layer(optionUpLabelLayer), true);
-    //layer_set_hidden(text_layer_get_layer(optionDownLabelLayer), false);
-    text_layer_set_text(optionUpLabelLayer, "");
-    text_layer_set_text(optionDownLabelLayer, "Next");
-  }
-  else
+  uint32_t beforeMs = chrono_splits()->before;
+  if (index > 0)
   {
-    //layer_set_hidden(text_layer_get_layer(optionUpLabelLayer), false);
-    //layer_set_hidden(text_layer_get_layer(optionDownLabelLayer), false);
-    text_layer_set_text(optionUpLabelLayer, "Prev");
-    text_layer_set_text(optionDownLabelLayer, "Next");
+    split_ring_iter_S iter = split_ring_iter(chrono_splits(), index - 1);
+    split_ring_next(&iter, &beforeMs);
   }
 
-  // Set current color text.
-  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s", colorSelectText[colorSelectChoice]);
-  text_layer_set_text(optionContentLayer, optionText);
+  return beforeMs;
+}
 
-  // Set current color as foreground.
-  text_layer_set_text_color(optionContentLayer, colorSelectColor[colorSelectChoice]);
+
+static uint32_t other_splits_key(int chronoIndex)
+{
+  return OTHER_SPLITS_FIRST_KEY + chronoIndex - 1;
 }
 
 
-// Color select UP button.
-static void color_select_up_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+// Save the splits of every chronometer to their split streams.
+static bool persist_save_splits()
+{
+  int selected = chrono_selected();
+  bool ok = true;
 
-  if (colorSelectChoice > MIN_COLOR_SELECTION_OFFSET)
+  for (int i = 0; i < CHRONO_COUNT && ok; i++)
   {
-    // Save choice.
-    colorSelectChoice--;
-
-    // Update option window to reflect choice.
-    color_select_set_choice();
+    chrono_select(i);
+    ok = (i == 0) ? split_stream_save(SPLIT_STREAM_FIRST_KEY, SPLIT_STREAM_FIRST_KEY + SPLIT_STREAM_MAX_KEYS, 0)
+                  : split_stream_save(other_splits_key(i), other_splits_key(i) + 1, 0);
   }
+
+  chrono_select(selected);
+  return ok;
 }
 
 
-// Color select DOWN button.
-static void color_select_down_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+// Restore the selected chronometer's splits from the split stream in keys "firstKey" up to "endKey".
+// "beforeMs" is the split before the earliest saved one, or zero, and "droppedCnt" the number of
+// splits replaced when full before it.
+static bool persist_restore_splits(uint32_t firstKey, uint32_t endKey, uint32_t beforeMs, uint32_t droppedCnt)
+{
+  split_stream_S stream;
 
-  if (colorSelectChoice < MAX_COLOR_SELECTION_OFFSET)
-  {
-    // Save choice.
-    colorSelectChoice++;
+  chrono_restore_no_splits();
 
-    // Update option window to reflect choice.
-    color_select_set_choice();
+  int splitCnt = split_stream_open(&stream, firstKey, endKey);
+  if (splitCnt < 0)
+  {
+    return false;
   }
-}
 
+  chrono_restore_splits_before(beforeMs);
+  chrono_restore_splits_dropped(droppedCnt);
 
-// Color select click configuration.
-static void color_select_click_config_provider(Window *window) {
-
-  window_single_click_subscribe(BUTTON_ID_UP, (ClickHandler) color_select_up_single_click_handler);
+  uint32_t splitMs = 0;
+  for (int i = 0; i < splitCnt && stream.ok; i++)
+  {
+    split_stream_next(&stream, &splitMs);
+    chrono_restore_split(splitMs);
+  }
 
-  window_single_click_subscribe(BUTTON_ID_DOWN, (ClickHandler) color_select_down_single_click_handler);
+  return stream.ok;
 }
-#endif
 
 
-//##################### Menu window support ################################
-
-void menuAppearHandler(struct Window *window) {
+// Bytes of persistent storage the live state needs, saved as it is now and with a full journal.
+// The session store may use the rest.
+static int persist_live_bytes()
+{
+  int bytes = PERSIST_DATA_MAX_LENGTH +      // State.
+              sizeof(int32_t) +              // Version.
+              SPLIT_JOURNAL_MAX * sizeof(journal_split_S) + CHRONO_COUNT * sizeof(journal_chrono_S) +
+              sizeof(session_index_S);
 
-  layer_set_hidden(text_layer_get_layer(optionUpLabelLayer), false);
-  text_layer_set_text(optionUpLabelLayer, "Yes");
+  int selected = chrono_selected();
+  for (int i = 0; i < CHRONO_COUNT; i++)
+  {
+    chrono_select(i);
+    bytes += split_stream_size(0);
+  }
+  chrono_select(selected);
 
-  layer_set_hidden(text_layer_get_layer(optionDownLabelLayer), false);
-  text_layer_set_text(optionDownLabelLayer, "No");
+  return bytes;
 }
 
 
-static void menuWatchChronoHandler(int index, void *context)
+// Write the splits of every chronometer, then the state. The state goes last as it holds the
+// journal base sequence: until it is written, the previous one replays the journal. Returns
+// false if any write failed.
+static bool persist_write_state(const uint8_t *state, int state_len)
 {
-  window_stack_push(time_window, true /* Animated */);
-}
-
+  if ( ! persist_save_splits())
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_write_data(split stream)");
+    return false;
+  }
 
-static void menuDisplaySplitsHandler(int index, void *context)
-{
-  format_splits_content();
+  int bytes_written = 0;
+  if (state_len != (bytes_written = persist_write_data(state_key, (void *)state, state_len)))
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_write_data(state). bytes written = %i", bytes_written);
+    return false;
+  }
 
-  splitDisplayIndex = 0;
-  select_splits_display_content();
+  return true;
+}
 
-  layer_set_hidden(bitmap_layer_get_layer(splitUpIconLayer), true);
 
-  if (splitIndex >= MAX_DISPLAY_SPLITS)
+// Delete the saved splits of the selected chronometer.
+static void persist_delete_selected_splits()
+{
+  int selected = chrono_selected();
+  if (selected == 0)
   {
-    layer_set_hidden(bitmap_layer_get_layer(splitDnIconLayer), false);
+    split_stream_delete(SPLIT_STREAM_FIRST_KEY, SPLIT_STREAM_FIRST_KEY + SPLIT_STREAM_MAX_KEYS);
   }
   else
   {
-    layer_set_hidden(bitmap_layer_get_layer(splitDnIconLayer), true);
+    split_stream_delete(other_splits_key(selected), other_splits_key(selected) + 1);
   }
+}
 
-  text_layer_set_text(splitContentLayer, splitsDisplayContent);
-  window_stack_push(split_window, true /* Animated */);
+
+// Delete all saved state and splits. Used when a problem has occurred saving any of it.
+static void persist_delete_state()
+{
+  persist_delete(state_key);
+  persist_delete(persist_version_key);
+  split_stream_delete(SPLIT_STREAM_FIRST_KEY, SPLIT_STREAM_FIRST_KEY + SPLIT_STREAM_MAX_KEYS);
+  split_stream_delete(other_splits_key(1), other_splits_key(CHRONO_COUNT));
 }
 
 
-static void menuClearSplitsHandler(int index, void *context)
+static uint8_t *state_put_field(uint8_t *dest, uint8_t tag, uint8_t len)
 {
-  window_set_click_config_provider(option_window, (ClickConfigProvider) clear_splits_click_config_provider);
+  dest[0] = tag;
+  dest[1] = len;
+  return &dest[2];
+}
 
-  if (splitIndex > 0)
+
+static uint8_t *state_put_u32(uint8_t *dest, uint32_t value)
+{
+  for (int i = 0; i < 4; i++)
   {
-    layer_set_hidden(text_layer_get_layer(optionDownLabelLayer), true);
-    text_layer_set_text(optionContentLayer, clearSplitsText);
+    dest[i] = (uint8_t)(value >> (8 * i));
   }
-  else
+  return &dest[4];
+}
+
+
+static uint32_t state_get_u32(const uint8_t *src)
+{
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++)
   {
-    layer_set_hidden(text_layer_get_layer(optionUpLabelLayer), true);
-    layer_set_hidden(text_layer_get_layer(optionDownLabelLayer), true);
-    text_layer_set_text(optionContentLayer, noSplitsText);
+    value |= (uint32_t)src[i] << (8 * i);
   }
-
-  window_stack_push(option_window, true /* Animated */);
+  return value;
 }
 
 
-static void menuSplitsOptionHandler(int index, void *context)
+// Lap statistics of the selected chronometer the splits alone cannot rebuild once some were replaced.
+static uint8_t *state_put_lap_stats(uint8_t *dest)
 {
-  window_set_click_config_provider(option_window, (ClickConfigProvider) splits_option_click_config_provider);
-
-  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s %s", splitsOptionText, splitsFullReplaceOldest);
-  text_layer_set_text(optionContentLayer, optionText);
-  window_stack_push(option_window, true /* Animated */);
+  const lap_stats_S *stats = chrono_lap_stats();
+  dest = state_put_u32(dest, (uint32_t)stats->count);
+  dest = state_put_u32(dest, stats->min);
+  dest = state_put_u32(dest, stats->max);
+  return state_put_u32(dest, stats->total);
 }
 
 
-static void menuResetOptionHandler(int index, void *context)
+static void state_get_lap_stats(const uint8_t *src, lap_stats_S *stats)
 {
-  window_set_click_config_provider(option_window, (ClickConfigProvider) reset_option_click_config_provider);
-
-  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s %s", resetOptionText, resetButtonClearsSplits);
-  text_layer_set_text(optionContentLayer, optionText);
-  window_stack_push(option_window, true /* Animated */);
+  lap_stats_clear(stats);
+  stats->count = (int)state_get_u32(src);
+  stats->min = state_get_u32(&src[4]);
+  stats->max = state_get_u32(&src[8]);
+  stats->total = state_get_u32(&src[12]);
 }
 
 
-static void menuColorInversionHandler(int index, void *context)
+// Save chronometer state and all splits. Only the model is saved; labels are derived on restore.
+static void persist_save_state()
 {
-  window_set_click_config_provider(option_window, (ClickConfigProvider) color_inversion_click_config_provider);
+  uint8_t state[PERSIST_DATA_MAX_LENGTH];
+  uint8_t *field;
 
-  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s %s", colorInversionText, colorInversionChoice);
-  text_layer_set_text(optionContentLayer, optionText);
-  window_stack_push(option_window, true /* Animated */);
-}
+  int selected = chrono_selected();
+  chrono_select(0);
 
+  field = state_put_field(state, STATE_TAG_MODE, 1);
+  field[0] = (uint8_t)selectedMode;
 
-#ifdef PBL_COLOR
-static void menuColorSelectHandler(int index, void *context)
-{
-  window_set_click_config_provider(option_window, (ClickConfigProvider) color_select_click_config_provider);
+  // Save the chronometer as of the next whole second to keep ms precision in a time_t.
+  time_t anchorTm = time(NULL) + 1;
+  field = state_put_field(&field[1], STATE_TAG_CHRONO, 9);
+  field[0] = chrono_running() ? RUN_START : RUN_STOP;
+  state_put_u32(state_put_u32(&field[1], chrono_elapsed_at((int64_t)anchorTm * 1000)), (uint32_t)anchorTm);
 
-  color_select_set_choice();
+  field = state_put_field(&field[9], STATE_TAG_FLAGS, 1);
+  field[0] = (chrono_has_been_reset() ? STATE_FLAG_CHRONO_RESET : 0) |
+             (settings_get(SETTING_RESET_CLEARS_SPLITS) ? STATE_FLAG_RESET_CLEARS_SPLITS : 0) |
+             (settings_get(SETTING_REPLACE_OLDEST) ? STATE_FLAG_REPLACE_OLDEST : 0) |
+             (settings_get(SETTING_COLOR_INVERSION) ? STATE_FLAG_COLOR_INVERSION : 0);
+  field = &field[1];
 
-  window_stack_push(option_window, true /* Animated */);
-}
-#endif
+  field = state_put_field(field, STATE_TAG_RUN_START, 4);
+  field = state_put_u32(field, (uint32_t)(chrono_run_start_ms() / 1000));
 
+  field = state_put_field(field, STATE_TAG_SELECTED_CHRONO, 1);
+  field[0] = (uint8_t)selected;
+  field = &field[1];
 
-//##################### Split window support ################################
+  field = state_put_field(field, STATE_TAG_SPLITS_BEFORE, 4);
+  field = state_put_u32(field, persist_split_before(0));
 
+  field = state_put_field(field, STATE_TAG_SPLITS_DROPPED, 4);
+  field = state_put_u32(field, chrono_splits()->dropped);
 
-void format_splits_content(){
+  field = state_put_field(field, STATE_TAG_LAP_STATS, STATE_LAP_STATS_LEN);
+  field = state_put_lap_stats(field);
 
-  if (splitIndex >= 0)
+  field = state_put_field(field, STATE_TAG_JOURNAL_BASE_SEQ, 4);
+  field = state_put_u32(field, baseSplitSeq);
+
+  for (int i = 1; i < CHRONO_COUNT; i++)
   {
-    int real_hours = splits[0]/3600;
-    int hours = real_hours%100;
-    int min = (splits[0] - real_hours*3600)/60;
-    int sec = (splits[0] - real_hours*3600 - min*60);
-    snprintf(formattedSplits, sizeof(formattedSplits), " 1)  %i:%02i:%02i", hours, min, sec);
+    chrono_select(i);
+    field = state_put_field(field, STATE_TAG_OTHER_CHRONO, STATE_OTHER_CHRONO_LEN);
+    field[0] = (uint8_t)i;
+    field[1] = chrono_running() ? RUN_START : RUN_STOP;
+    field = state_put_u32(state_put_u32(&field[2], chrono_elapsed_at((int64_t)anchorTm * 1000)), (uint32_t)anchorTm);
+    field[0] = chrono_has_been_reset() ? STATE_FLAG_CHRONO_RESET : 0;
+    field = state_put_u32(&field[1], (uint32_t)(chrono_run_start_ms() / 1000));
+    field = state_put_u32(field, persist_split_before(0));
+    field = state_put_u32(field, chrono_splits()->dropped);
+    field = state_put_lap_stats(field);
+  }
+  chrono_select(selected);
 
-    bool moreSplits = true;
-    for  (int i = 1; i <= splitIndex && moreSplits; i++)
-    {
-      if (splits[i] > 0)
-      {
-        real_hours = splits[i]/3600;
-        hours = real_hours%100;
-        min = (splits[i] - real_hours*3600)/60;
-        sec = (splits[i] - real_hours*3600 - min*60);
-
-        // Format. Each line contains one split and must be exactly CHARS_PER_SPLIT wide.
-        // "blanks" fill does not seem to work for integers, so do it manually.
-        int oneBasedCnt = i + 1;
-        if (oneBasedCnt < 10)
-        {
-          if (hours < 10)
-          {
-            snprintf(formattedSplits, sizeof(formattedSplits), "%s\n %i)  %i:%02i:%02i", formattedSplits, oneBasedCnt, hours, min, sec);
-          }
-          else
-          {
-            snprintf(formattedSplits, sizeof(formattedSplits), "%s\n %i) %i:%02i:%02i", formattedSplits, oneBasedCnt, hours, min, sec);
-          }
-        }
-        else
-        {
-          if (hours < 10)
-          {
-            snprintf(formattedSplits, sizeof(formattedSplits), "%s\n%i)  %i:%02i:%02i", formattedSplits, oneBasedCnt, hours, min, sec);
-          }
-          else
-          {
-            snprintf(formattedSplits, sizeof(formattedSplits), "%s\n%i) %i:%02i:%02i", formattedSplits, oneBasedCnt, hours, min, sec);
-          }
-        }
-      }
-      else
-      {
-        moreSplits = false;
-      }
-    }
+  #ifdef PBL_COLOR
+  field = state_put_field(field, STATE_TAG_COLOR_ARGB8, 1);
+  field[0] = palette_color(settings_color_select()).argb;
+  field = &field[1];
+  #endif
+
+  // Sessions give way to the live state. They are evicted so it fits before writing, and all of
+  // them should a write fail anyway.
+  session_store_make_room(persist_live_bytes(), 0, false);
+
+  int state_len = field - state;
+  bool ok = persist_write_state(state, state_len);
+  if ( ! ok && session_store_evict_all())
+  {
+    ok = persist_write_state(state, state_len);
+  }
+
+  if ( ! ok)
+  {
+    // Delete all peristent data when a problem has occurred saving any of it.
+    persist_delete_state();
   }
   else
   {
-    strcpy(formattedSplits, SPLITS_DISPLAY_NONE);
+    persist_write_int(persist_version_key, PERSIST_VERSION);
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "all state data saved");
   }
+
+  // State of older versions is no longer needed.
+  persist_delete(persistent_data_key);
+  persist_delete(extended_splits_key);
+  persist_delete(journal_base_seq_key);
 }
 
 
-void select_splits_display_content() {
+// Apply a saved STATE_TAG_OTHER_CHRONO field of "len" bytes, including the chronometer's splits.
+static void persist_apply_other_chrono(const uint8_t *value, int len)
+{
+  chrono_select(value[0]);
 
-  // Get up to MAX_DISPLAY_SPLITS rows beginning at splitDisplayIndex.
-  strncpy(splitsDisplayContent,
-          &(formattedSplits[splitDisplayIndex * CHARS_PER_SPLIT]),
-          MAX_DISPLAY_SPLITS * CHARS_PER_SPLIT);
+  chrono_restore(value[1], state_get_u32(&value[2]), (int64_t)state_get_u32(&value[6]) * 1000,
+                 (value[10] & STATE_FLAG_CHRONO_RESET) != 0);
+  chrono_restore_run_start((int64_t)state_get_u32(&value[11]) * 1000);
 
-  // Replace trailing \n with \0.
-  memset(splitsDisplayContent + (MAX_DISPLAY_SPLITS * CHARS_PER_SPLIT), 0, 1);
+  if ( ! persist_restore_splits(other_splits_key(value[0]), other_splits_key(value[0]) + 1,
+                                state_get_u32(&value[15]),
+                                (len >= STATE_OTHER_CHRONO_DROPPED_LEN) ? state_get_u32(&value[19]) : 0))
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_read_data(chronometer %i splits)", value[0] + 1);
+    chrono_restore_no_splits();
+  }
+  else if (len >= STATE_OTHER_CHRONO_LEN)
+  {
+    lap_stats_S lapStats;
+    state_get_lap_stats(&value[23], &lapStats);
+    chrono_restore_lap_stats(&lapStats);
+  }
+
+  chrono_select(0);
 }
 
 
-// Splits UP button. Scroll up a whole page.
-static void splits_up_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+// Apply the fields of a saved state to the first chronometer, which must be selected, and to
+// the others. Sets "splitsBeforeMs" to the split before the first chronometer's earliest saved
+// split, "splitsDroppedCnt" to the splits replaced before it and "lapStats" to its saved lap
+// statistics, all applied with its splits. Returns the chronometer to select.
+static int persist_apply_state(const uint8_t *state, int state_len, uint32_t *splitsBeforeMs,
+                               uint32_t *splitsDroppedCnt, lap_stats_S *lapStats)
+{
+  int selected = 0;
+  short runSelect = RUN_STOP;
+  uint32_t elapsed = 0;
+  int64_t anchorMs = 0;
+  bool hasBeenReset = true;
 
-  // If not on first page, scroll back a page.
-  if (splitDisplayIndex - MAX_DISPLAY_SPLITS >= 0)
+  for (int i = 0; i + 2 <= state_len && i + 2 + state[i + 1] <= state_len; i += 2 + state[i + 1])
   {
-    splitDisplayIndex -= MAX_DISPLAY_SPLITS;
+    uint8_t tag = state[i];
+    uint8_t len = state[i + 1];
+    const uint8_t *value = &state[i + 2];
 
-    select_splits_display_content();
-
-    text_layer_set_text(splitContentLayer, splitsDisplayContent);
-
-    // If page going to is not first, show UP icon. KAB
-    if (splitDisplayIndex > 0)
+    if (tag == STATE_TAG_MODE && len >= 1)
     {
-      layer_set_hidden(bitmap_layer_get_layer(splitUpIconLayer), false);
+      selectedMode = value[0] % MODE_MAX;
     }
-    else
+    else if (tag == STATE_TAG_CHRONO && len >= 9)
+    {
+      runSelect = value[0];
+      elapsed = state_get_u32(&value[1]);
+      anchorMs = (int64_t)state_get_u32(&value[5]) * 1000;
+    }
+    else if (tag == STATE_TAG_FLAGS && len >= 1)
+    {
+      hasBeenReset = (value[0] & STATE_FLAG_CHRONO_RESET) != 0;
+      settings_set(SETTING_RESET_CLEARS_SPLITS, (value[0] & STATE_FLAG_RESET_CLEARS_SPLITS) != 0);
+      settings_set(SETTING_REPLACE_OLDEST, (value[0] & STATE_FLAG_REPLACE_OLDEST) != 0);
+      settings_set(SETTING_COLOR_INVERSION, (value[0] & STATE_FLAG_COLOR_INVERSION) != 0);
+    }
+    else if (tag == STATE_TAG_RUN_START && len >= 4)
+    {
+      chrono_restore_run_start((int64_t)state_get_u32(value) * 1000);
+    }
+    else if (tag == STATE_TAG_SELECTED_CHRONO && len >= 1 && value[0] < CHRONO_COUNT)
+    {
+      selected = value[0];
+    }
+    else if (tag == STATE_TAG_SPLITS_BEFORE && len >= 4)
     {
-      layer_set_hidden(bitmap_layer_get_layer(splitUpIconLayer), true);
+      *splitsBeforeMs = state_get_u32(value);
     }
+    else if (tag == STATE_TAG_SPLITS_DROPPED && len >= 4)
+    {
+      *splitsDroppedCnt = state_get_u32(value);
+    }
+    else if (tag == STATE_TAG_LAP_STATS && len >= STATE_LAP_STATS_LEN)
+    {
+      state_get_lap_stats(value, lapStats);
+    }
+    else if (tag == STATE_TAG_JOURNAL_BASE_SEQ && len >= 4)
+    {
+      baseSplitSeq = state_get_u32(value);
+    }
+    else if (tag == STATE_TAG_OTHER_CHRONO && len >= STATE_OTHER_CHRONO_MIN_LEN && value[0] > 0 &&
+             value[0] < CHRONO_COUNT)
+    {
+      persist_apply_other_chrono(value, len);
+    }
+    #ifdef PBL_COLOR
+    else if (tag == STATE_TAG_COLOR && len >= 1 && palette_from_legacy(value[0]) >= 0)
+    {
+      settings_set_color_select(palette_from_legacy(value[0]));
+    }
+    else if (tag == STATE_TAG_COLOR_ARGB8 && len >= 1 && palette_find((GColor8){.argb = value[0]}) >= 0)
+    {
+      settings_set_color_select(palette_find((GColor8){.argb = value[0]}));
+    }
+    #endif
+  }
 
-    // Always need a DOWN icon.
-    layer_set_hidden(bitmap_layer_get_layer(splitDnIconLayer), false);
+  // Chronometer had the elapsed ms at the anchor.
+  chrono_restore(runSelect, elapsed, anchorMs, hasBeenReset);
 
-  }
+  return selected;
 }
 
 
-// Splits DOWN button. Scroll down a whole page.
-static void splits_down_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+// Restore chronometer state and splits saved before PERSIST_VERSION_TLV.
+// They are saved in the current format on the next compaction.
+static void persist_migrate_state(int savedVersion)
+{
+  if (persist_exists(persistent_data_key))
+  {
+    saved_state_S saved_state;
+    int bytes_read = 0;
+    if (sizeof(saved_state_S) == (bytes_read = persist_read_data(persistent_data_key,
+                                                                 (void *)&saved_state,
+                                                                 sizeof(saved_state_S))))
+    {
+      //(APP_LOG_LEVEL_DEBUG, "read state: selectedMode: %i, chronoRunSelect: %i, closeTm: %i",
+      //                             saved_state.selectedMode,
+      //                             saved_state.chronoRunSelect,
+      //                             (int)saved_state.closeTm);
+
+      selectedMode = saved_state.selectedMode % MODE_MAX;
+
+      // Data saved before millisecond resolution holds times in seconds.
+      bool savedInSeconds = savedVersion < PERSIST_VERSION_MS;
+      if (savedInSeconds)
+      {
+        saved_state.chronoElapsed *= 1000;
+      }
+
+      // Chronometer had chronoElapsed at closeTm.
+      chrono_restore(saved_state.chronoRunSelect, saved_state.chronoElapsed,
+                     (int64_t)saved_state.closeTm * 1000, saved_state.chronoHasBeenReset);
+      settings_set(SETTING_RESET_CLEARS_SPLITS, strcmp(saved_state.resetButtonClearsSplits, OPTION_CHOICE_YES) == 0);
+      settings_set(SETTING_REPLACE_OLDEST, strcmp(saved_state.splitsFullReplaceOldest, OPTION_CHOICE_YES) == 0);
+      settings_set(SETTING_COLOR_INVERSION, strcmp(saved_state.colorInversionChoice, OPTION_CHOICE_YES) == 0);
+      #ifdef PBL_COLOR
+      if (palette_from_legacy(saved_state.colorSelectChoice) >= 0)
+      {
+        settings_set_color_select(palette_from_legacy(saved_state.colorSelectChoice));
+      }
+      #endif
+
+      // Get splits from their stream.
+      if (savedVersion >= PERSIST_VERSION_SPLIT_STREAM)
+      {
+        if ( ! persist_restore_splits(SPLIT_STREAM_FIRST_KEY, SPLIT_STREAM_FIRST_KEY + SPLIT_STREAM_MAX_KEYS, 0, 0))
+        {
+          APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_read_data(split stream)");
+          chrono_restore_no_splits();
+        }
+      }
+
+      // Get saved extended splits before restoring all splits.
+      else if (persist_exists(extended_splits_key))
+      {
+        saved_splits_S saved_splits;
+        int bytes_read = 0;
+        if (sizeof(saved_splits_S) == (bytes_read = persist_read_data(extended_splits_key,
+                                                                     (void *)&saved_splits,
+                                                                     sizeof(saved_splits_S))))
+        {
+          // Saved splits are earliest first, beginning in the base set.
+          for (int i = 0; i <= saved_state.splitIndex && i < BASE_SPLIT_CNT + EXTENDED_SPLIT_CNT; i++)
+          {
+            uint32_t splitMs = (i < BASE_SPLIT_CNT) ? saved_state.splits[i]
+                                                    : saved_splits.splits[i - BASE_SPLIT_CNT];
+            chrono_restore_split(savedInSeconds ? splitMs * 1000 : splitMs);
+          }
+        }
+        else
+        {
+          APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_read_data(saved_splits). bytes read = %i", bytes_read);
+        }
+      }
+      else
+      {
+        APP_LOG(APP_LOG_LEVEL_DEBUG, "persist_exists(saved_splits) returned false");
+      }
+    }
+    else
+    {
+      APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_read_data(saved_state). bytes read = %i", bytes_read);
+    }
+  }
+  else
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "persist_exists(saved_state) returned false");
+  }
+}
+
+
+// Restore chronometer state and all splits. Anything not restored keeps its default.
+// Data saved before there were several chronometers restores the first.
+static void persist_restore_state()
+{
+  for (int i = CHRONO_COUNT - 1; i >= 0; i--)
+  {
+    chrono_select(i);
+    chrono_restore_no_splits();
+  }
+
+  // Journal base sequence, unless the state holds it.
+  baseSplitSeq = persist_exists(journal_base_seq_key) ? (uint32_t)persist_read_int(journal_base_seq_key) : 0;
+
+  // Data without a version key predates millisecond resolution.
+  int savedVersion = persist_exists(persist_version_key) ? persist_read_int(persist_version_key)
+                                                         : PERSIST_VERSION_SECONDS;
+  if (savedVersion < PERSIST_VERSION_TLV)
+  {
+    persist_migrate_state(savedVersion);
+    return;
+  }
+
+  uint8_t state[PERSIST_DATA_MAX_LENGTH];
+  int state_len = persist_read_data(state_key, (void *)state, sizeof(state));
+  if (state_len > 0)
+  {
+    uint32_t splitsBeforeMs = 0;
+    uint32_t splitsDroppedCnt = 0;
+    lap_stats_S lapStats;
+    lap_stats_clear(&lapStats);
+    int selected = persist_apply_state(state, state_len, &splitsBeforeMs, &splitsDroppedCnt, &lapStats);
+
+    if ( ! persist_restore_splits(SPLIT_STREAM_FIRST_KEY, SPLIT_STREAM_FIRST_KEY + SPLIT_STREAM_MAX_KEYS,
+                                  splitsBeforeMs, splitsDroppedCnt))
+    {
+      APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_read_data(split stream)");
+      chrono_restore_no_splits();
+    }
+    else
+    {
+      chrono_restore_lap_stats(&lapStats);
+    }
+
+    chrono_select(selected);
+  }
+  else
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_read_data(state). bytes read = %i", state_len);
+  }
+}
+
+
+// Run state journal key of chronometer "index".
+static uint32_t chrono_journal_key_of(int index)
+{
+  return (index == 0) ? chrono_journal_key : (uint32_t)(OTHER_CHRONO_JOURNAL_FIRST_KEY + index - 1);
+}
+
+
+// Write the saved state, then drop journal records it now includes. The state holds the journal
+// base sequence, so once it is written, replay skips those records even before they are dropped.
+// Should this be interrupted between the splits and the state, journaled splits can at worst be
+// restored twice, never lost.
+static void persist_compact()
+{
+  baseSplitSeq = splitSeq;
+  persist_save_state();
+
+  for (int i = 0; i < SPLIT_JOURNAL_MAX; i++)
+  {
+    persist_delete(SPLIT_JOURNAL_FIRST_KEY + i);
+  }
+  for (int i = 0; i < CHRONO_COUNT; i++)
+  {
+    persist_delete(chrono_journal_key_of(i));
+  }
+}
+
+
+// Record a split just added to the selected chronometer.
+static void persist_journal_split(uint32_t splitMs)
+{
+  splitSeq++;
+
+  int journalCnt = splitSeq - baseSplitSeq;
+  if (journalCnt > SPLIT_JOURNAL_MAX)
+  {
+    persist_compact();
+  }
+  else
+  {
+    journal_split_S journal_split = {.splitMs = splitMs, .seq = splitSeq, .chrono = (uint8_t)chrono_selected()};
+    persist_write_data(SPLIT_JOURNAL_FIRST_KEY + journalCnt - 1, (void *)&journal_split, sizeof(journal_split));
+  }
+}
+
+
+// Record the selected chronometer's run state after it changed.
+static void persist_journal_chrono()
+{
+  // Anchor on the next whole second to keep ms precision, as for the saved state.
+  journal_chrono_S journal_chrono;
+  journal_chrono.chronoRunSelect = chrono_running() ? RUN_START : RUN_STOP;
+  journal_chrono.anchorTm = time(NULL) + 1;
+  journal_chrono.chronoElapsed = chrono_elapsed_at((int64_t)journal_chrono.anchorTm * 1000);
+  journal_chrono.chronoHasBeenReset = chrono_has_been_reset();
+
+  persist_write_data(chrono_journal_key_of(chrono_selected()), (void *)&journal_chrono, sizeof(journal_chrono));
+}
+
+
+// Apply journal records written after the saved state.
+static void persist_replay_journal()
+{
+  splitSeq = baseSplitSeq;
+
+  int selected = chrono_selected();
+
+  // Records left over from an interrupted compaction do not continue the sequence and end the replay.
+  journal_split_S journal_split;
+  for (int i = 0; i < SPLIT_JOURNAL_MAX; i++)
+  {
+    int len = persist_read_data(SPLIT_JOURNAL_FIRST_KEY + i, (void *)&journal_split, sizeof(journal_split));
+    if (len == (int)JOURNAL_SPLIT_LEN_FIRST_CHRONO)
+    {
+      journal_split.chrono = 0;
+    }
+    else if (len != sizeof(journal_split))
+    {
+      break;
+    }
+
+    if (journal_split.seq != splitSeq + 1 || journal_split.chrono >= CHRONO_COUNT)
+    {
+      break;
+    }
+
+    chrono_select(journal_split.chrono);
+    chrono_restore_split(journal_split.splitMs);
+    splitSeq++;
+  }
+
+  journal_chrono_S journal_chrono;
+  for (int i = 0; i < CHRONO_COUNT; i++)
+  {
+    if (sizeof(journal_chrono) == persist_read_data(chrono_journal_key_of(i),
+                                                    (void *)&journal_chrono,
+                                                    sizeof(journal_chrono)))
+    {
+      chrono_select(i);
+      chrono_restore(journal_chrono.chronoRunSelect, journal_chrono.chronoElapsed,
+                     (int64_t)journal_chrono.anchorTm * 1000, journal_chrono.chronoHasBeenReset);
+    }
+  }
+
+  chrono_select(selected);
+
+  if (splitSeq != baseSplitSeq)
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "replayed %i journaled splits", (int)(splitSeq - baseSplitSeq));
+  }
+}
+
+
+// ### Session store ###
+
+static uint32_t session_first_key(int slot)
+{
+  return SESSION_FIRST_KEY + slot * SESSION_KEYS;
+}
+
+
+static void session_store_save_index()
+{
+  int bytes_written = 0;
+  if (sizeof(sessionIndex) != (bytes_written = persist_write_data(session_index_key, (void *)&sessionIndex,
+                                                                  sizeof(sessionIndex))))
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_write_data(session index). bytes written = %i", bytes_written);
+  }
+}
+
+
+static bool session_store_used(int slot)
+{
+  return sessionIndex.sessions[slot].startTm != 0;
+}
+
+
+static void session_store_evict(int slot)
+{
+  sessionIndex.sessions[slot].startTm = 0;
+  split_stream_delete(session_first_key(slot), session_first_key(slot) + SESSION_KEYS);
+}
+
+
+// Read the session index. A session's splits are only read when it is opened.
+static void session_store_load()
+{
+  if (sizeof(sessionIndex) != persist_read_data(session_index_key, (void *)&sessionIndex, sizeof(sessionIndex)) ||
+      sessionIndex.format != SESSION_INDEX_FORMAT)
+  {
+    // Splits of sessions the index no longer describes would only take up storage.
+    memset(&sessionIndex, 0, sizeof(sessionIndex));
+    sessionIndex.format = SESSION_INDEX_FORMAT;
+    for (int slot = 0; slot < SESSION_MAX; slot++)
+    {
+      session_store_evict(slot);
+    }
+  }
+}
+
+
+// Evict least recently used sessions until "bytes" more fit the persistent storage that
+// "liveBytes" of live state leave, and one slot is free if "needSlot". Returns a free slot, or
+// -1 if none or if "bytes" do not fit even with every session evicted.
+static int session_store_make_room(int liveBytes, int bytes, bool needSlot)
+{
+  int budget = PERSIST_QUOTA_BYTES - liveBytes;
+  bool evicted = false;
+
+  while (true)
+  {
+    int freeSlot = -1;
+    int lruSlot = -1;
+    int usedBytes = 0;
+    for (int slot = 0; slot < SESSION_MAX; slot++)
+    {
+      if ( ! session_store_used(slot))
+      {
+        freeSlot = slot;
+      }
+      else
+      {
+        usedBytes += sessionIndex.sessions[slot].bytes;
+        if (lruSlot < 0 || sessionIndex.sessions[slot].lastUse < sessionIndex.sessions[lruSlot].lastUse)
+        {
+          lruSlot = slot;
+        }
+      }
+    }
+
+    bool fits = usedBytes + bytes <= budget;
+    if (lruSlot < 0 || (fits && (freeSlot >= 0 || ! needSlot)))
+    {
+      if (evicted)
+      {
+        session_store_save_index();
+      }
+      return fits ? freeSlot : -1;
+    }
+
+    session_store_evict(lruSlot);
+    evicted = true;
+  }
+}
+
+
+// Evict every session. Returns false if there were none.
+static bool session_store_evict_all()
+{
+  bool evicted = false;
+  for (int slot = 0; slot < SESSION_MAX; slot++)
+  {
+    if (session_store_used(slot))
+    {
+      session_store_evict(slot);
+      evicted = true;
+    }
+  }
+
+  if (evicted)
+  {
+    session_store_save_index();
+  }
+  return evicted;
+}
+
+
+// Archive the selected chronometer's run and its latest SESSION_MAX_SPLITS splits as a session.
+// Called before the splits are cleared.
+static void session_store_archive()
+{
+  int splitCnt = split_ring_count(chrono_splits());
+  if (splitCnt == 0)
+  {
+    return;
+  }
+
+  int index = (splitCnt > SESSION_MAX_SPLITS) ? splitCnt - SESSION_MAX_SPLITS : 0;
+  int bytes = split_stream_size(index);
+
+  uint32_t beforeMs = persist_split_before(index);
+
+  // Room is made for the live state as it will be once these splits are cleared.
+  int slot = session_store_make_room(persist_live_bytes() - split_stream_size(0), bytes, true);
+  if (slot < 0)
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "no room to archive session of %i bytes", bytes);
+    return;
+  }
+
+  // Until the clear is saved, the splits are still stored live too. Should both not fit, their
+  // live copy, about to be cleared anyway, is deleted first.
+  bool ok = split_stream_save(session_first_key(slot), session_first_key(slot) + SESSION_KEYS, index);
+  if ( ! ok)
+  {
+    persist_delete_selected_splits();
+    ok = split_stream_save(session_first_key(slot), session_first_key(slot) + SESSION_KEYS, index);
+  }
+
+  if ( ! ok)
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_write_data(session splits)");
+    session_store_evict(slot);
+  }
+  else
+  {
+    // Run start is unknown when lost in an abnormal exit. Count back from now instead.
+    int64_t nowMs = chrono_now_ms();
+    uint32_t totalMs = chrono_elapsed_at(nowMs);
+    int64_t startMs = (chrono_run_start_ms() != 0) ? chrono_run_start_ms() : nowMs - totalMs;
+
+    sessionIndex.sessions[slot] = (session_S){.startTm = (uint32_t)(startMs / 1000),
+                                              .totalMs = totalMs,
+                                              .splitCnt = splitCnt - index,
+                                              .bytes = bytes,
+                                              .lastUse = ++sessionIndex.useSeq,
+                                              .beforeMs = beforeMs,
+                                              .dropped = chrono_splits()->dropped + index};
+  }
+
+  session_store_save_index();
+}
+
+
+// Open a session to view. It becomes the most recently used, and its lap statistics are
+// built into "stats". Returns false if its splits cannot be read.
+static bool session_store_open(int slot, lap_stats_S *stats)
+{
+  sessionIndex.sessions[slot].lastUse = ++sessionIndex.useSeq;
+  session_store_save_index();
+
+  lap_stats_clear(stats);
+  stats->latestSplit = sessionIndex.sessions[slot].beforeMs;
+
+  split_stream_S stream;
+  int splitCnt = split_stream_open(&stream, session_first_key(slot), session_first_key(slot) + SESSION_KEYS);
+  uint32_t splitMs = 0;
+  for (int i = 0; i < splitCnt && stream.ok; i++)
+  {
+    split_stream_next(&stream, &splitMs);
+    lap_stats_add(stats, splitMs);
+  }
+
+  return splitCnt >= 0 && stream.ok;
+}
+
+
+// Read up to "cnt" splits of a session from logical "index" into "splits", and the split
+// before them into "prevMs". Returns the number read.
+static int session_store_read(int slot, int index, uint32_t *splits, int cnt, uint32_t *prevMs)
+{
+  split_stream_S stream;
+  int splitCnt = split_stream_open(&stream, session_first_key(slot), session_first_key(slot) + SESSION_KEYS);
+
+  // Splits are differences from the previous, so read from the first.
+  uint32_t splitMs = 0;
+  int read = 0;
+  *prevMs = sessionIndex.sessions[slot].beforeMs;
+  for (int i = 0; i < splitCnt && read < cnt && stream.ok; i++)
+  {
+    if (i == index && i > 0)
+    {
+      *prevMs = splitMs;
+    }
+
+    split_stream_next(&stream, &splitMs);
+
+    if (i >= index && stream.ok)
+    {
+      splits[read++] = splitMs;
+    }
+  }
+
+  return read;
+}
+
+
+//##################### Option window support ################################
+
+// ### Clear splits support ###
+
+static bool clear_splits_ready()
+{
+  return split_ring_count(chrono_splits()) > 0;
+}
+
+
+// Clear splits, keeping them as a saved session. Split button is relabeled when the time window appears again.
+static void clear_splits_action()
+{
+  session_store_archive();
+  chrono_clear_splits();
+}
+
+// ### Yes/No option support ###
+
+// Show a Yes/No option's prompt and current choice.
+static void option_show_choice(const option_S *option)
+{
+  if (optionText == NULL)
+  {
+    return;
+  }
+
+  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s %s",
+           option->prompt, settings_get(option->setting) ? OPTION_CHOICE_YES : OPTION_CHOICE_NO);
+  text_layer_set_text(optionContentLayer, optionText);
+}
+
+
+// Time window picks up new colors when it appears again.
+static void option_colors_changed(SettingId setting)
+{
+  tcColorStale = true;
+}
+
+
+// ### Color select support ###
+
+#ifdef PBL_COLOR
+static void color_select_set_choice()
+{
+  // Adjust DOWN/UP button text.
+  if (settings_color_select() >= palette_count() - 1)
+  {
+    //layer_set_hidden(text_layer_get_layer(optionUpLabelLayer), false);
+    //layer_set_hidden(text_layer_get_layer(optionDownLabelLayer), true);
+    text_layer_set_text(optionUpLabelLayer, "Prev");
+    text_layer_set_text(optionDownLabelLayer, "");
+  }
+  else if (settings_color_select() <= 0)
+  {
+    //layer_set_hidden(text_layer_get_layer(optionUpLabelLayer), true);
+    //layer_set_hidden(text_layer_get_layer(optionDownLabelLayer), false);
+    text_layer_set_text(optionUpLabelLayer, "");
+    text_layer_set_text(optionDownLabelLayer, "Next");
+  }
+  else
+  {
+    //layer_set_hidden(text_layer_get_layer(optionUpLabelLayer), false);
+    //layer_set_hidden(text_layer_get_layer(optionDownLabelLayer), false);
+    text_layer_set_text(optionUpLabelLayer, "Prev");
+    text_layer_set_text(optionDownLabelLayer, "Next");
+  }
+
+  // Set current color text, with its group.
+  if (optionText == NULL)
+  {
+    return;
+  }
+  snprintf(optionText, OPTION_TEXT_MAX_LEN, "%s\n(%s)",
+           palette_name(settings_color_select()), palette_group_name(settings_color_select()));
+  text_layer_set_text(optionContentLayer, optionText);
+
+  // Set current color as foreground.
+  text_layer_set_text_color(optionContentLayer, palette_color(settings_color_select()));
+}
+
+
+// Color select UP long press. Back to the start of this group, or of the previous group if already there.
+static void color_select_up_long_click_handler(ClickRecognizerRef recognizer, Window *window) {
+
+  int groupFirst = palette_group_first(settings_color_select(), 0);
+  settings_set_color_select(groupFirst < settings_color_select() ? groupFirst
+                                                                 : palette_group_first(settings_color_select(), -1));
+}
+
+
+// Color select DOWN long press. Forward to the start of the next group.
+static void color_select_down_long_click_handler(ClickRecognizerRef recognizer, Window *window) {
+
+  settings_set_color_select(palette_group_first(settings_color_select(), 1));
+}
+#endif
+
+// ### Option window buttons ###
+
+// Show the shown option's prompt and choice, or an action's confirmation.
+static void option_show()
+{
+  if (optionShown->type == OPTION_TYPE_ACTION)
+  {
+    layer_set_hidden(text_layer_get_layer(optionDownLabelLayer), true);
+    if (optionShown->ready())
+    {
+      text_layer_set_text(optionContentLayer, optionShown->prompt);
+    }
+    else
+    {
+      layer_set_hidden(text_layer_get_layer(optionUpLabelLayer), true);
+      text_layer_set_text(optionContentLayer, optionShown->idleText);
+    }
+  }
+  else if (optionShown->type == OPTION_TYPE_YES_NO)
+  {
+    option_show_choice(optionShown);
+  }
+  #ifdef PBL_COLOR
+  else if (optionShown->type == OPTION_TYPE_COLOR)
+  {
+    color_select_set_choice();
+  }
+  #endif
+}
+
+
+// Option UP button - do the action, choose Yes, or the previous color.
+static void option_up_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+
+  if (optionShown->type == OPTION_TYPE_ACTION)
+  {
+    if (optionShown->ready())
+    {
+      optionShown->action();
+      text_layer_set_text(optionContentLayer, optionShown->doneText);
+    }
+  }
+  else if (optionShown->type == OPTION_TYPE_YES_NO)
+  {
+    settings_set(optionShown->setting, true);
+  }
+  #ifdef PBL_COLOR
+  else if (settings_color_select() > 0)
+  {
+    settings_set_color_select(settings_color_select() - 1);
+  }
+  #endif
+}
+
+
+// Option DOWN button - choose No, or the next color.
+static void option_down_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+
+  if (optionShown->type == OPTION_TYPE_YES_NO)
+  {
+    settings_set(optionShown->setting, false);
+  }
+  #ifdef PBL_COLOR
+  else if (optionShown->type == OPTION_TYPE_COLOR && settings_color_select() < palette_count() - 1)
+  {
+    settings_set_color_select(settings_color_select() + 1);
+  }
+  #endif
+}
+
+
+// Option click configuration, for the option shown.
+static void option_click_config_provider(Window *window) {
+
+  window_single_click_subscribe(BUTTON_ID_UP, (ClickHandler) option_up_single_click_handler);
+
+  window_single_click_subscribe(BUTTON_ID_DOWN, (ClickHandler) option_down_single_click_handler);
+
+  #ifdef PBL_COLOR
+  if (optionShown->type == OPTION_TYPE_COLOR)
+  {
+    window_long_click_subscribe(BUTTON_ID_UP, COLOR_GROUP_LONG_CLICK_MS, (ClickHandler) color_select_up_long_click_handler, NULL);
+
+    window_long_click_subscribe(BUTTON_ID_DOWN, COLOR_GROUP_LONG_CLICK_MS, (ClickHandler) color_select_down_long_click_handler, NULL);
+  }
+  #endif
+}
+
+
+// A setting was changed, in the option window or on restore. Tell the options stored in it,
+// and show the new choice if it is the option shown.
+static void option_setting_changed(SettingId setting)
+{
+  for (int i = 0; i < OPTION_COUNT; i++)
+  {
+    if (optionTable[i].type != OPTION_TYPE_ACTION && optionTable[i].setting == setting && optionTable[i].changed != NULL)
+    {
+      optionTable[i].changed(setting);
+    }
+  }
+
+  // Option layers only exist while the option window is loaded.
+  if (option_window == NULL || ! window_is_loaded(option_window) ||
+      optionShown->type == OPTION_TYPE_ACTION || optionShown->setting != setting)
+  {
+    return;
+  }
+
+  option_show();
+}
+
+// ### Option window setup ###
+
+// Layers are created fresh on each push, so every option starts with "Yes"/"No" labels.
+static void option_window_load(Window *window)
+{
+  Layer * option_window_layer = window_get_root_layer(window);
+
+  optionText = malloc(OPTION_TEXT_MAX_LEN);
+
+  // Up button label - "Yes"
+  optionUpLabelLayer = text_layer_create(GRect(0, 0, 142, 28));
+  text_layer_set_text_alignment(optionUpLabelLayer, GTextAlignmentRight);
+  text_layer_set_font(optionUpLabelLayer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
+  text_layer_set_background_color(optionUpLabelLayer, GColorWhite);
+  text_layer_set_text_color(optionUpLabelLayer, GColorBlack);
+  text_layer_set_text(optionUpLabelLayer, OPTION_CHOICE_YES);
+  layer_add_child(option_window_layer, text_layer_get_layer(optionUpLabelLayer));
+
+  // Option content
+  optionContentLayer = text_layer_create(GRect(4, 32, 136, 136));
+  text_layer_set_text_alignment(optionContentLayer, GTextAlignmentCenter);
+  text_layer_set_font(optionContentLayer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
+  text_layer_set_background_color(optionContentLayer, GColorWhite);
+  text_layer_set_text_color(optionContentLayer, GColorBlack);
+  layer_add_child(option_window_layer, text_layer_get_layer(optionContentLayer));
+
+  // Down button label - "No"
+  optionDownLabelLayer = text_layer_create(GRect(0, 141, 142, 26));
+  text_layer_set_text_alignment(optionDownLabelLayer, GTextAlignmentRight);
+  text_layer_set_font(optionDownLabelLayer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
+  text_layer_set_background_color(optionDownLabelLayer, GColorWhite);
+  text_layer_set_text_color(optionDownLabelLayer, GColorBlack);
+  text_layer_set_text(optionDownLabelLayer, OPTION_CHOICE_NO);
+  layer_add_child(option_window_layer, text_layer_get_layer(optionDownLabelLayer));
+}
+
+
+static void option_window_unload(Window *window)
+{
+  text_layer_destroy(optionContentLayer);
+  text_layer_destroy(optionUpLabelLayer);
+  text_layer_destroy(optionDownLabelLayer);
+
+  free(optionText);
+  optionText = NULL;
+}
+
+
+// Push the option window showing "option".
+static void option_window_push(const option_S *option)
+{
+  optionShown = option;
+
+  if (option_window == NULL)
+  {
+    option_window = window_create();
+    window_set_fullscreen(option_window, true);
+    window_set_background_color(option_window, GColorWhite);
+    window_set_window_handlers(option_window, (WindowHandlers){.load = option_window_load,
+                                                               .unload = option_window_unload});
+    window_set_click_config_provider(option_window, (ClickConfigProvider) option_click_config_provider);
+  }
+
+  window_stack_push(option_window, true /* Animated */);
+  option_show();
+}
+
+
+//##################### Session browser support #############################
+
+// Menu items for the saved sessions, newest first, and the slot of each.
+#define SESSION_TITLE_LEN 18    // "Oct 16   2:05PM"
+#define SESSION_SUBTITLE_LEN 25 // Worst case "1193:02:47, 65535 splits"
+typedef struct session_menu_S
+{
+  SimpleMenuItem items[SESSION_MAX];
+  int slots[SESSION_MAX];
+  char titles[SESSION_MAX][SESSION_TITLE_LEN];
+  char subtitles[SESSION_MAX][SESSION_SUBTITLE_LEN];
+} session_menu_S;
+static session_menu_S *sessionMenu = NULL; // Allocated while the browser is loaded.
+
+
+// Open the selected session in the splits window. Only now are its splits read. A session
+// whose splits cannot be read is dropped, and the browser stays where it is.
+static void session_select_handler(int index, void *context)
+{
+  int slot = sessionMenu->slots[index];
+  if ( ! session_store_used(slot))
+  {
+    return;
+  }
+
+  if ( ! session_store_open(slot, &sessionLapStats))
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_read_data(session splits)");
+    session_store_evict(slot);
+    session_store_save_index();
+
+    strcpy(sessionMenu->subtitles[index], "Not readable");
+    layer_mark_dirty(simple_menu_layer_get_layer(sessionMenuLayer));
+    return;
+  }
+
+  // First page is shown when the splits window loads.
+  splitsSession = slot;
+  splitDisplayIndex = 0;
+  split_window_push();
+}
+
+
+// Title is the session's start "Oct 16  14:05", subtitle its total time and splits "1:23:45, 12 splits".
+static void session_format_item(int item, int slot)
+{
+  const session_S *session = &sessionIndex.sessions[slot];
+
+  time_t startTm = session->startTm;
+  strftime(sessionMenu->titles[item], SESSION_TITLE_LEN, clock_is_24h ? "%b %e  %H:%M" : "%b %e  %l:%M%p",
+           localtime(&startTm));
+
+  int totalSec = session->totalMs / 1000;
+  snprintf(sessionMenu->subtitles[item], SESSION_SUBTITLE_LEN, "%d:%02d:%02d, %d splits",
+           totalSec / 3600, (totalSec / 60) % 60, totalSec % 60, session->splitCnt);
+
+  sessionMenu->items[item] = (SimpleMenuItem){.title = sessionMenu->titles[item],
+                                              .subtitle = sessionMenu->subtitles[item],
+                                              .callback = session_select_handler,
+                                              .icon = NULL};
+}
+
+
+static void session_window_load(Window *window)
+{
+  Layer * session_window_layer = window_get_root_layer(window);
+
+  sessionMenu = malloc(sizeof(session_menu_S));
+  if (sessionMenu == NULL)
+  {
+    sessionMenuLayer = NULL;
+    return;
+  }
+
+  // Sort used slots newest first.
+  int itemCnt = 0;
+  for (int slot = 0; slot < SESSION_MAX; slot++)
+  {
+    if (session_store_used(slot))
+    {
+      int item = itemCnt++;
+      while (item > 0 && sessionIndex.sessions[sessionMenu->slots[item - 1]].startTm < sessionIndex.sessions[slot].startTm)
+      {
+        sessionMenu->slots[item] = sessionMenu->slots[item - 1];
+        item--;
+      }
+      sessionMenu->slots[item] = slot;
+    }
+  }
+
+  for (int item = 0; item < itemCnt; item++)
+  {
+    session_format_item(item, sessionMenu->slots[item]);
+  }
+
+  if (itemCnt == 0)
+  {
+    sessionMenu->items[0] = (SimpleMenuItem){.title = "No sessions",
+                                             .subtitle = NULL,
+                                             .callback = NULL,
+                                             .icon = NULL};
+    itemCnt = 1;
+  }
+
+  sessionSection[0] = (SimpleMenuSection){.items = sessionMenu->items, .num_items = itemCnt, .title = NULL};
+
+  sessionMenuLayer = simple_menu_layer_create(layer_get_bounds(session_window_layer),
+                                              window,
+                                              sessionSection,
+                                              1,
+                                              NULL);
+
+  layer_add_child(session_window_layer, simple_menu_layer_get_layer(sessionMenuLayer));
+}
+
+
+static void session_window_unload(Window *window)
+{
+  if (sessionMenuLayer != NULL)
+  {
+    simple_menu_layer_destroy(sessionMenuLayer);
+  }
+  free(sessionMenu);
+  sessionMenu = NULL;
+}
+
+
+static void session_window_push()
+{
+  if (session_window == NULL)
+  {
+    session_window = window_create();
+    window_set_fullscreen(session_window, true);
+    window_set_window_handlers(session_window, (WindowHandlers){.load = session_window_load,
+                                                                .unload = session_window_unload});
+  }
+
+  window_stack_push(session_window, true /* Animated */);
+}
+
+
+//##################### Menu window support ################################
+
+static void menuWatchChronoHandler(int index, void *context)
+{
+  window_stack_push(time_window, true /* Animated */);
+}
+
+
+static void menuDisplaySplitsHandler(int index, void *context)
+{
+  // First page is shown when the splits window loads.
+  splitsSession = SPLITS_SESSION_NONE;
+  splitDisplayIndex = 0;
+  split_window_push();
+}
+
+
+static void menuSavedSessionsHandler(int index, void *context)
+{
+  session_window_push();
+}
+
+
+static void menuOptionHandler(int index, void *context)
+{
+  option_window_push(&optionTable[index - MENU_FIRST_OPTION]);
+}
+
+// ### Menu window setup ###
+
+static void menu_window_load(Window *window)
+{
+  Layer * menu_window_layer = window_get_root_layer(window);
+
+  menuIcon = gbitmap_create_with_resource(RESOURCE_ID_MENU_IMAGE);
+
+  menuItems[0] = (SimpleMenuItem){.title = "Display Splits",
+                                  .subtitle = NULL,
+                                  .callback = menuDisplaySplitsHandler,
+                                  .icon = NULL};
+  menuItems[1] = (SimpleMenuItem){.title = "Saved Sessions",
+                                  .subtitle = NULL,
+                                  .callback = menuSavedSessionsHandler,
+                                  .icon = NULL};
+  for (int i = 0; i < OPTION_COUNT; i++)
+  {
+    menuItems[MENU_FIRST_OPTION + i] = (SimpleMenuItem){.title = optionTable[i].title,
+                                                        .subtitle = NULL,
+                                                        .callback = menuOptionHandler,
+                                                        .icon = NULL};
+  }
+  menuItems[NBR_MENU_ITEMS - 1] = (SimpleMenuItem){.title = APP_VERSION,
+                                  .subtitle = NULL,
+                                  .callback = NULL,
+                                  .icon = NULL};
+
+  menuSection[0] = (SimpleMenuSection){.items = menuItems, .num_items = NBR_MENU_ITEMS, .title = NULL};
+
+  menuLayer = simple_menu_layer_create(layer_get_bounds(menu_window_layer),
+                                       window,
+                                       menuSection,
+                                       1,
+                                       NULL);
+
+  simple_menu_layer_set_selected_index(menuLayer, 0, true);
+  layer_add_child(menu_window_layer, simple_menu_layer_get_layer(menuLayer));
+}
+
+
+static void menu_window_unload(Window *window)
+{
+  simple_menu_layer_destroy(menuLayer);
+  gbitmap_destroy(menuIcon);
+}
+
+
+static void menu_window_push()
+{
+  if (menu_window == NULL)
+  {
+    menu_window = window_create();
+    window_set_fullscreen(menu_window, true);
+    window_set_window_handlers(menu_window, (WindowHandlers){.load = menu_window_load,
+                                                             .unload = menu_window_unload});
+  }
+
+  window_stack_push(menu_window, true /* Animated */);
+}
+
+
+//##################### Split window support ################################
+
+
+// Write "value" right aligned into exactly "width" chars at "dest". Leading positions are "fill".
+static void format_digits(char *dest, unsigned int value, int width, char fill)
+{
+  for (int i = width - 1; i >= 0; i--)
+  {
+    dest[i] = (i == width - 1 || value > 0) ? (char)('0' + value % 10) : fill;
+    value /= 10;
+  }
+}
+
+
+// Write the time " 1:23:45\n" that ends each row, from char 5 of "row".
+static void format_row_time(char *row, uint32_t splitMs)
+{
+  // Splits are displayed in whole seconds. Limit display to 2 hours digits.
+  time_t splitSec = splitMs / 1000;
+
+  format_digits(&row[5], (splitSec / 3600) % 100, 2, ' ');
+  row[7] = ':';
+  format_digits(&row[8], (splitSec / 60) % 60, 2, '0');
+  row[10] = ':';
+  format_digits(&row[11], splitSec % 60, 2, '0');
+  row[13] = '\n';
+}
+
+
+// Write one split or lap row "  1)  1:23:45\n" of exactly CHARS_PER_SPLIT chars at "row".
+// Numbers from 1000 take the space after the bracket, "1000) 1:23:45". Past 9999 only the
+// last four digits are shown.
+static void format_split_row(char *row, uint32_t oneBasedCnt, uint32_t splitMs)
+{
+  if (oneBasedCnt < 1000)
+  {
+    format_digits(&row[0], oneBasedCnt, 3, ' ');
+    row[3] = ')';
+    row[4] = ' ';
+  }
+  else
+  {
+    format_digits(&row[0], oneBasedCnt % 10000, 4, '0');
+    row[4] = ')';
+  }
+  format_row_time(row, splitMs);
+}
+
+
+// Write one lap statistic row "Fast   1:23:45\n" of exactly CHARS_PER_SPLIT chars at "row".
+static void format_stat_row(char *row, int stat, uint32_t lapMs)
+{
+  memcpy(row, LAP_STAT_LABEL[stat], LAP_STAT_LABEL_LEN);
+  format_row_time(row, lapMs);
+}
+
+
+// Number of splits shown, of the chronometer or the session.
+static int splits_count()
+{
+  return (splitsSession == SPLITS_SESSION_NONE) ? split_ring_count(chrono_splits())
+                                                : sessionIndex.sessions[splitsSession].splitCnt;
+}
+
+
+// Number of the split at logical index 0. Splits keep their numbers when the earliest are
+// replaced, or left out of a session.
+static uint32_t splits_first_number()
+{
+  return (splitsSession == SPLITS_SESSION_NONE) ? chrono_splits()->dropped + 1
+                                                : sessionIndex.sessions[splitsSession].dropped + 1;
+}
+
+
+static const lap_stats_S *splits_lap_stats()
+{
+  return (splitsSession == SPLITS_SESSION_NONE) ? chrono_lap_stats() : &sessionLapStats;
+}
+
+
+// Read the splits of a page from logical "index" into "pageMs", and the split before them
+// into "prevMs". Returns the number read.
+static int splits_read_page(int index, uint32_t *pageMs, uint32_t *prevMs)
+{
+  if (splitsSession != SPLITS_SESSION_NONE)
+  {
+    return session_store_read(splitsSession, index, pageMs, MAX_DISPLAY_SPLITS, prevMs);
+  }
+
+  const split_ring_S *ring = chrono_splits();
+  *prevMs = ring->before;
+  split_ring_iter_S iter = split_ring_iter(ring, index > 0 ? index - 1 : 0);
+  if (index > 0)
+  {
+    split_ring_next(&iter, prevMs);
+  }
+
+  int read = 0;
+  while (read < MAX_DISPLAY_SPLITS && split_ring_next(&iter, &pageMs[read]))
+  {
+    read++;
+  }
+
+  return read;
+}
+
+
+// Number of display rows, including the statistics page in laps mode.
+static int splits_display_rows()
+{
+  int count = splits_count();
+  return (splitsShowLaps && count > 0) ? count + MAX_DISPLAY_SPLITS : count;
+}
+
+
+// Format the lap statistics page. Returns the number of rows.
+static int select_lap_stats_display_content()
+{
+  const lap_stats_S *stats = splits_lap_stats();
+  uint32_t statMs[LAP_STATS_ROWS] = {stats->min, stats->max, lap_stats_mean(stats), lap_stats_rolling(stats)};
+
+  for (int row = 0; row < LAP_STATS_ROWS; row++)
+  {
+    format_stat_row(&splitsDisplayContent[row * CHARS_PER_SPLIT], row, statMs[row]);
+  }
+
+  return LAP_STATS_ROWS;
+}
+
+
+// Render the page of up to MAX_DISPLAY_SPLITS rows beginning at splitDisplayIndex.
+// Only the visible rows are formatted. In laps mode, each lap is measured from the split before it.
+void select_splits_display_content() {
+
+  if (splitsDisplayContent == NULL)
+  {
+    return;
+  }
+
+  if (splits_count() == 0)
+  {
+    strcpy(splitsDisplayContent, SPLITS_DISPLAY_NONE);
+    return;
+  }
+
+  int rows;
+  if (splitsShowLaps && splitDisplayIndex == 0)
+  {
+    rows = select_lap_stats_display_content();
+  }
+  else
+  {
+    int index = splitsShowLaps ? splitDisplayIndex - MAX_DISPLAY_SPLITS : splitDisplayIndex;
+    uint32_t pageMs[MAX_DISPLAY_SPLITS];
+    uint32_t prevMs;
+    rows = splits_read_page(index, pageMs, &prevMs);
+
+    for (int row = 0; row < rows; row++)
+    {
+      format_split_row(&splitsDisplayContent[row * CHARS_PER_SPLIT], splits_first_number() + index + row,
+                       splitsShowLaps ? split_lap(prevMs, pageMs[row]) : pageMs[row]);
+      prevMs = pageMs[row];
+    }
+  }
+
+  // Splits that could not be read.
+  if (rows == 0)
+  {
+    strcpy(splitsDisplayContent, SPLITS_DISPLAY_NONE);
+    return;
+  }
+
+  // Replace trailing \n with \0.
+  splitsDisplayContent[rows * CHARS_PER_SPLIT - 1] = '\0';
+}
+
+
+// Show the page beginning at splitDisplayIndex, with UP/DOWN icons where there are more pages.
+static void splits_show_page()
+{
+  select_splits_display_content();
+
+  if (splitsSession == SPLITS_SESSION_NONE)
+  {
+    text_layer_set_text(splitTitleLayer, splitsShowLaps ? "Laps" : "Splits");
+  }
+  else
+  {
+    text_layer_set_text(splitTitleLayer, splitsShowLaps ? "Session Laps" : "Session");
+  }
+  text_layer_set_text(splitContentLayer, splitsDisplayContent);
+
+  layer_set_hidden(bitmap_layer_get_layer(splitUpIconLayer), splitDisplayIndex == 0);
+  layer_set_hidden(bitmap_layer_get_layer(splitDnIconLayer),
+                   splitDisplayIndex + MAX_DISPLAY_SPLITS >= splits_display_rows());
+}
+
+
+// Splits UP button. Scroll up a whole page.
+static void splits_up_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+
+  // If not on first page, scroll back a page.
+  if (splitDisplayIndex - MAX_DISPLAY_SPLITS >= 0)
+  {
+    splitDisplayIndex -= MAX_DISPLAY_SPLITS;
+
+    splits_show_page();
+  }
+}
+
+
+// Splits DOWN button. Scroll down a whole page.
+static void splits_down_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
 
   // If not on last page, scroll forward a page.
   int lastIndexOnDisplay = splitDisplayIndex + MAX_DISPLAY_SPLITS - 1;
-  if (lastIndexOnDisplay < splitIndex)
+  if (lastIndexOnDisplay < splits_display_rows() - 1)
   {
     splitDisplayIndex += MAX_DISPLAY_SPLITS;
 
-    select_splits_display_content();
+    splits_show_page();
+  }
+}
+
+
+// Splits SELECT button. Toggle between splits and laps, from the first page.
+static void splits_select_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+
+  splitsShowLaps = ! splitsShowLaps;
+  splitDisplayIndex = 0;
+
+  splits_show_page();
+}
+
+
+// Splits click configuration.
+static void splits_click_config_provider(Window *window) {
+
+  window_single_click_subscribe(BUTTON_ID_UP, (ClickHandler) splits_up_single_click_handler);
+
+  window_single_click_subscribe(BUTTON_ID_DOWN, (ClickHandler) splits_down_single_click_handler);
+
+  window_single_click_subscribe(BUTTON_ID_SELECT, (ClickHandler) splits_select_single_click_handler);
+}
+
+// ### Splits window setup ###
+
+// Page text is only held while the splits window is loaded. Returns false if out of memory.
+static bool splits_content_open()
+{
+  splitsDisplayContent = malloc(SPLITS_CONTENT_LEN);
+
+  return splitsDisplayContent != NULL;
+}
+
+
+static void splits_content_close()
+{
+  free(splitsDisplayContent);
+  splitsDisplayContent = NULL;
+}
+
+
+// Arrow images and page text are loaded with the window and released when it is popped.
+static void split_window_load(Window *window)
+{
+  Layer * split_window_layer = window_get_root_layer(window);
+
+  splits_content_open();
+
+  up_image = gbitmap_create_with_resource(RESOURCE_ID_UP_ICON);
+  dn_image = gbitmap_create_with_resource(RESOURCE_ID_DN_ICON);
+
+  // Title
+  splitTitleLayer = text_layer_create(GRect(0, 0, 144, 28));
+  text_layer_set_text_alignment(splitTitleLayer, GTextAlignmentCenter);
+  text_layer_set_font(splitTitleLayer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
+  text_layer_set_background_color(splitTitleLayer, GColorWhite);
+  text_layer_set_text_color(splitTitleLayer, GColorBlack);
+  layer_add_child(split_window_layer, text_layer_get_layer(splitTitleLayer));
+
+  // UP icon
+  splitUpIconLayer = bitmap_layer_create(GRect(129, 4, 15, 15));
+  bitmap_layer_set_bitmap(splitUpIconLayer, up_image);
+  layer_add_child(split_window_layer, bitmap_layer_get_layer(splitUpIconLayer));
+
+  // Splits content
+  splitContentLayer = text_layer_create(GRect(0, 32, 144, 136));
+  text_layer_set_text_alignment(splitContentLayer, GTextAlignmentCenter);
+  text_layer_set_font(splitContentLayer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
+  text_layer_set_background_color(splitContentLayer, GColorWhite);
+  text_layer_set_text_color(splitContentLayer, GColorBlack);
+  layer_add_child(split_window_layer, text_layer_get_layer(splitContentLayer));
+
+  // DOWN icon
+  splitDnIconLayer = bitmap_layer_create(GRect(129, 157, 15, 15));
+  bitmap_layer_set_bitmap(splitDnIconLayer, dn_image);
+  layer_add_child(split_window_layer, bitmap_layer_get_layer(splitDnIconLayer));
+
+  splits_show_page();
+}
+
+
+static void split_window_unload(Window *window)
+{
+  bitmap_layer_destroy(splitDnIconLayer);
+  text_layer_destroy(splitContentLayer);
+  bitmap_layer_destroy(splitUpIconLayer);
+  text_layer_destroy(splitTitleLayer);
+  gbitmap_destroy(up_image);
+  gbitmap_destroy(dn_image);
+
+  splits_content_close();
+}
+
+
+static void split_window_push()
+{
+  if (split_window == NULL)
+  {
+    split_window = window_create();
+    window_set_fullscreen(split_window, true);
+    window_set_background_color(split_window, GColorBlack);
+    window_set_window_handlers(split_window, (WindowHandlers){.load = split_window_load,
+                                                              .unload = split_window_unload});
+    window_set_click_config_provider(split_window, (ClickConfigProvider) splits_click_config_provider);
+  }
+
+  window_stack_push(split_window, true /* Animated */);
+}
+
+//##################### Time/chrono window support ##########################
+
+void timeAppearHandler(struct Window *window) {
+
+  // Colors are only reapplied after a color setting changed.
+  if (tcColorStale)
+  {
+    tc_set_color();
+    tcColorStale = false;
+  }
+
+  // Display was not kept up while covered. Bring all of it up to date.
+  if (selectedMode == MODE_CHRON)
+  {
+    if (resetInProgress == false)
+    {
+      tc_show_chrono();
+    }
+  }
+  else
+  {
+    tc_show_clock_now();
+  }
+
+  // Split/reset label may have been affected by options or cleared splits.
+  tc_update_spt_rst_label();
+
+  timeWindowVisible = true;
+  tc_update_redraw_rate();
+}
+
+
+void timeDisappearHandler(struct Window *window) {
+
+  timeWindowVisible = false;
+  tc_update_redraw_rate();
+}
+
+
+// NULL if out of memory. The icon is then not drawn and its layer stays blank.
+static GBitmap *icon_create(GSize size)
+{
+  #ifdef PBL_COLOR
+  GBitmap *icon = gbitmap_create_blank(size, GBitmapFormat8Bit);
+  #else
+  GBitmap *icon = gbitmap_create_blank(size, GBitmapFormat1Bit);
+  #endif
+
+  if (icon == NULL)
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "no memory for %ix%i icon", size.w, size.h);
+  }
+  return icon;
+}
+
+
+static void icon_destroy(GBitmap *icon)
+{
+  if (icon != NULL)
+  {
+    gbitmap_destroy(icon);
+  }
+}
+
+
+static void icon_set_pixel(GBitmap *icon, int x, int y, GColor color)
+{
+  uint8_t *row = gbitmap_get_data(icon) + y * gbitmap_get_bytes_per_row(icon);
+
+  #ifdef PBL_COLOR
+  row[x] = color.argb;
+  #else
+  // Least significant bit is leftmost. Set bits are white.
+  if (gcolor_equal(color, GColorWhite))
+  {
+    row[x / 8] |= 1 << (x % 8);
+  }
+  else
+  {
+    row[x / 8] &= ~(1 << (x % 8));
+  }
+  #endif
+}
+
+
+static void icon_fill(GBitmap *icon, GColor color)
+{
+  GRect bounds = gbitmap_get_bounds(icon);
+  for (int y = 0; y < bounds.size.h; y++)
+  {
+    for (int x = 0; x < bounds.size.w; x++)
+    {
+      icon_set_pixel(icon, x, y, color);
+    }
+  }
+}
+
+
+// Horizontal, vertical or diagonal line, end points included.
+static void icon_draw_line(GBitmap *icon, GPoint from, GPoint to, GColor color)
+{
+  int stepX = (to.x > from.x) ? 1 : (to.x < from.x) ? -1 : 0;
+  int stepY = (to.y > from.y) ? 1 : (to.y < from.y) ? -1 : 0;
+
+  for (GPoint p = from; ; p.x += stepX, p.y += stepY)
+  {
+    icon_set_pixel(icon, p.x, p.y, color);
+    if (p.x == to.x && p.y == to.y)
+    {
+      break;
+    }
+  }
+}
 
-    text_layer_set_text(splitContentLayer, splitsDisplayContent);
 
-    // Always need an UP icon.
-    layer_set_hidden(bitmap_layer_get_layer(splitUpIconLayer), false);
+// Circle outline, midpoint algorithm.
+static void icon_draw_circle(GBitmap *icon, GPoint center, int radius, GColor color)
+{
+  int x = radius;
+  int y = 0;
+  int err = 1 - radius;
 
-    // If page going to is not last, show DOWN icon.
-    if (splitDisplayIndex + MAX_DISPLAY_SPLITS <= splitIndex)
+  while (x >= y)
+  {
+    icon_set_pixel(icon, center.x + x, center.y + y, color);
+    icon_set_pixel(icon, center.x - x, center.y + y, color);
+    icon_set_pixel(icon, center.x + x, center.y - y, color);
+    icon_set_pixel(icon, center.x - x, center.y - y, color);
+    icon_set_pixel(icon, center.x + y, center.y + x, color);
+    icon_set_pixel(icon, center.x - y, center.y + x, color);
+    icon_set_pixel(icon, center.x + y, center.y - x, color);
+    icon_set_pixel(icon, center.x - y, center.y - x, color);
+
+    y++;
+    if (err < 0)
     {
-      layer_set_hidden(bitmap_layer_get_layer(splitDnIconLayer), false);
+      err += 2 * y + 1;
     }
     else
     {
-      layer_set_hidden(bitmap_layer_get_layer(splitDnIconLayer), true);
+      x--;
+      err += 2 * (y - x) + 1;
     }
-
   }
 }
 
 
-// Splits click configuration.
-static void splits_click_config_provider(Window *window) {
-
-  window_single_click_subscribe(BUTTON_ID_UP, (ClickHandler) splits_up_single_click_handler);
-
-  window_single_click_subscribe(BUTTON_ID_DOWN, (ClickHandler) splits_down_single_click_handler);
-}
-
-//##################### Time/chrono window support ##########################
-
-void timeAppearHandler(struct Window *window) {
-
-  tc_set_color();
-}
-
-
-void tc_lightLayer_update_proc (Layer *my_layer, GContext* ctx)
+// Draw the start/stop and light icons in the given colors.
+static void tc_render_icons(GColor foreground, GColor background)
 {
-  // Dark foreground on white background.
-  if (strcmp(colorInversionChoice, OPTION_CHOICE_NO) == 0)
+  // STOP icon, a square.
+  if (stopIcon != NULL)
   {
-    graphics_context_set_stroke_color(ctx, colorDark);
+    icon_fill(stopIcon, background);
+    for (int y = 8; y <= 21; y++)
+    {
+      icon_draw_line(stopIcon, GPoint(0, y), GPoint(13, y), foreground);
+    }
   }
 
-  // White foreground on dark background.
-  else
+  // START icon, a triangle from the left edge at rows 8 to 22, pointing right to (12, 15).
+  if (startIcon != NULL)
   {
-    graphics_context_set_stroke_color(ctx, GColorWhite);
+    icon_fill(startIcon, background);
+    for (int y = 8; y <= 22; y++)
+    {
+      int fromMiddle = (y < 15) ? 15 - y : y - 15;
+      icon_draw_line(startIcon, GPoint(0, y), GPoint(12 * (7 - fromMiddle) / 7, y), foreground);
+    }
+  }
+
+  if (lightIcon == NULL)
+  {
+    return;
   }
 
-  graphics_draw_circle(ctx, GPoint(7, 7), 3);
+  icon_fill(lightIcon, background);
+  icon_draw_circle(lightIcon, GPoint(7, 7), 3, foreground);
 
   // East West
-  graphics_draw_line(ctx, GPoint(2, 7), GPoint(3, 7));
-  graphics_draw_line(ctx, GPoint(11, 7), GPoint(12, 7));
+  icon_draw_line(lightIcon, GPoint(2, 7), GPoint(3, 7), foreground);
+  icon_draw_line(lightIcon, GPoint(11, 7), GPoint(12, 7), foreground);
 
   // Northwest Southeast
-  graphics_draw_line(ctx, GPoint(3, 3), GPoint(4, 4));
-  graphics_draw_line(ctx, GPoint(10, 10), GPoint(11, 11));
+  icon_draw_line(lightIcon, GPoint(3, 3), GPoint(4, 4), foreground);
+  icon_draw_line(lightIcon, GPoint(10, 10), GPoint(11, 11), foreground);
 
   // North South
-  graphics_draw_line(ctx, GPoint(7, 2), GPoint(7, 3));
-  graphics_draw_line(ctx, GPoint(7, 11), GPoint(7, 12));
+  icon_draw_line(lightIcon, GPoint(7, 2), GPoint(7, 3), foreground);
+  icon_draw_line(lightIcon, GPoint(7, 11), GPoint(7, 12), foreground);
 
   // Northeast Southwest
-  graphics_draw_line(ctx, GPoint(11, 3), GPoint(10, 4));
-  graphics_draw_line(ctx, GPoint(3, 11), GPoint(4, 10));
+  icon_draw_line(lightIcon, GPoint(11, 3), GPoint(10, 4), foreground);
+  icon_draw_line(lightIcon, GPoint(3, 11), GPoint(4, 10), foreground);
 }
 
 
-void tc_ssLayer_update_proc (Layer *my_layer, GContext* ctx)
+// Set STOP icon when running, START icon when stopped.
+static void tc_show_run_icon()
 {
-  // Dark foreground on white background.
-  if (strcmp(colorInversionChoice, OPTION_CHOICE_NO) == 0)
-  {
-    graphics_context_set_fill_color(ctx, colorDark);
-  }
-
-  // White foreground on dark background.
-  else
-  {
-    graphics_context_set_fill_color(ctx, GColorWhite);
-  }
-
-  // Set STOP icon when running.
-  if (chronoRunSelect == RUN_START)
-  {
-    gpath_draw_filled(ctx, stopIconP);
-  }
-
-  // Set START icon when stopped.
-  else
-  {
-    gpath_draw_filled(ctx, startIconP);
-  }
+  bitmap_layer_set_bitmap(ssLayer, chrono_running() ? stopIcon : startIcon);
 }
 
 
 static void tc_set_color()
 {
   #ifdef PBL_COLOR
-  colorDark = colorSelectColor[colorSelectChoice];
+  colorDark = palette_color(settings_color_select());
   #else
   colorDark = GColorBlack;
   #endif
 
   // Dark foreground on white background.
-  if (strcmp(colorInversionChoice, OPTION_CHOICE_NO) == 0)
+  if ( ! settings_get(SETTING_COLOR_INVERSION))
   {
     window_set_background_color(time_window, GColorWhite);
     text_layer_set_background_color(modeButtonLayer, GColorWhite);
-    text_layer_set_background_color(timeChronoHhmmLayer, GColorWhite);
-    text_layer_set_background_color(timeChronoSecLayer, GColorWhite);
     text_layer_set_background_color(dateInfoLayer, GColorWhite);
     text_layer_set_background_color(sptRstButtonLayer, GColorWhite);
 
@@ -796,94 +2522,108 @@ static void tc_set_color()
     bitmap_layer_set_background_color(lightLayer, GColorWhite);
 
     text_layer_set_text_color(modeButtonLayer, colorDark);
-    text_layer_set_text_color(timeChronoHhmmLayer, colorDark);
-    text_layer_set_text_color(timeChronoSecLayer, colorDark);
     text_layer_set_text_color(dateInfoLayer, colorDark);
     text_layer_set_text_color(sptRstButtonLayer, colorDark);
+
+    digit_layer_set_colors(timeChronoHhmmLayer, colorDark, GColorWhite);
+    digit_layer_set_colors(timeChronoSecLayer, colorDark, GColorWhite);
+    digit_layer_set_colors(timeChronoFracLayer, colorDark, GColorWhite);
   }
 
   // White foreground on dark background.
   else
   {
     text_layer_set_text_color(modeButtonLayer, GColorWhite);
-    text_layer_set_text_color(timeChronoHhmmLayer, GColorWhite);
-    text_layer_set_text_color(timeChronoSecLayer, GColorWhite);
     text_layer_set_text_color(dateInfoLayer, GColorWhite);
     text_layer_set_text_color(sptRstButtonLayer, GColorWhite);
 
     window_set_background_color(time_window, colorDark);
     text_layer_set_background_color(modeButtonLayer, colorDark);
-    text_layer_set_background_color(timeChronoHhmmLayer, colorDark);
-    text_layer_set_background_color(timeChronoSecLayer, colorDark);
     text_layer_set_background_color(dateInfoLayer, colorDark);
     text_layer_set_background_color(sptRstButtonLayer, colorDark);
 
     bitmap_layer_set_background_color(ssLayer, colorDark);
     bitmap_layer_set_background_color(lightLayer, colorDark);
+
+    digit_layer_set_colors(timeChronoHhmmLayer, GColorWhite, colorDark);
+    digit_layer_set_colors(timeChronoSecLayer, GColorWhite, colorDark);
+    digit_layer_set_colors(timeChronoFracLayer, GColorWhite, colorDark);
   }
 
-  // Redraw graphics based on current color option to set foreground color.
-  layer_mark_dirty((Layer*)ssLayer);
-  layer_mark_dirty((Layer*)lightLayer);
+  // Redraw icons in the new colors. Setting the bitmaps again marks their layers dirty.
+  if ( ! settings_get(SETTING_COLOR_INVERSION))
+  {
+    tc_render_icons(colorDark, GColorWhite);
+  }
+  else
+  {
+    tc_render_icons(GColorWhite, colorDark);
+  }
+  tc_show_run_icon();
+  bitmap_layer_set_bitmap(lightLayer, lightIcon);
 }
 
 
-// 
-static void tc_set_tc_layer_text() 
+// Display hours/minutes and seconds, updating only the fields that changed.
+static void tc_show_time(int hours, int min, int sec)
 {
-  // Remove ":ss" and set hours/minutes with remainder.
-  static char tempHhmm [MAX_TIME_TEXT_LEN];
-  int hhMmLen = strlen(timeText) - 3;
-  strncpy(tempHhmm, timeText, hhMmLen); 
-  tempHhmm[hhMmLen] = '\0';
-  text_layer_set_text(timeChronoHhmmLayer, tempHhmm);
+  int hhmm = hours * 100 + min;
+  if (hhmm != shownHhmm)
+  {
+    format_digits(&hhmmText[0], hours, 2, ' ');
+    format_digits(&hhmmText[3], min, 2, '0');
+    digit_layer_set_text(timeChronoHhmmLayer, hhmmText);
+    shownHhmm = hhmm;
+  }
 
-  //APP_LOG(APP_LOG_LEVEL_DEBUG, "len: %i, HHMM >%s<", hhMmLen, tempHhmm);
+  if (sec != shownSec)
+  {
+    format_digits(secText, sec, 2, '0');
+    digit_layer_set_text(timeChronoSecLayer, secText);
+    shownSec = sec;
+  }
+}
 
-  // Set seconds.
-  char * secStartPtr = &(timeText[hhMmLen + 1]);
-  text_layer_set_text(timeChronoSecLayer, secStartPtr);
 
-  //APP_LOG(APP_LOG_LEVEL_DEBUG, "SS >%s<", &(timeText[hhMmLen + 1]));
+// Time layers were given other text. Next tc_show_time() must redraw all fields.
+static void tc_forget_shown_time()
+{
+  shownHhmm = TIME_FIELD_UNKNOWN;
+  shownSec = TIME_FIELD_UNKNOWN;
 }
 
-// Used by time/chronometer window. Called once per second.
-static void tc_handle_second_tick(struct tm *currentTime, TimeUnits units_changed) 
+
+// Display chronometer time, including tenths of a second.
+static void tc_show_chrono()
 {
-  // Maintain a running chronometer whether or not currently being displayed.
-  if (chronoRunSelect == RUN_START)
-  {
-    chronoElapsed += 1;
-  }
+  uint32_t chronoElapsed = chrono_elapsed();
 
-  if (selectedMode == MODE_CHRON && resetInProgress == false)
-  {
+  // Limit display to 2 hours digits.
+  time_t elapsedSec = chronoElapsed / 1000;
+  tc_show_time((elapsedSec / 3600) % 100, (elapsedSec / 60) % 60, elapsedSec % 60);
 
-    // Limit display to 2 hours digits.
-    int real_hours = chronoElapsed/3600;
-    int hours = real_hours%100;
-    int min = (chronoElapsed - real_hours*3600)/60;
-    int sec = (chronoElapsed - real_hours*3600 - min*60);
+  char tenths = '0' + (chronoElapsed % 1000) / 100;
+  if (chronoFracText[1] != tenths || digit_layer_get_text(timeChronoFracLayer) != chronoFracText)
+  {
+    chronoFracText[1] = tenths;
+    digit_layer_set_text(timeChronoFracLayer, chronoFracText);
+  }
+}
 
-    // Format.
-    snprintf(timeText, sizeof(timeText), "%2i:%02i:%02i", hours, min, sec);
 
-    tc_set_tc_layer_text();
-  }
-  else if (selectedMode == MODE_CLOCK)
+// Display time of day. Date is rebuilt only when the day changed, per "units_changed".
+static void tc_show_clock(struct tm *currentTime, TimeUnits units_changed)
+{
+  int hourStyled = currentTime->tm_hour;
+  if ( ! clock_is_24h && hourStyled > 12)
   {
-    int hourStyled = currentTime->tm_hour;
-    if ( ! clock_is_24h && hourStyled > 12)
-    {
-      hourStyled -= 12;
-    }
-
-    snprintf(timeText, sizeof(timeText), "%2i:%02i:%02i", hourStyled,
-                                                           currentTime->tm_min,
-                                                           currentTime->tm_sec);
+    hourStyled -= 12;
+  }
 
-    tc_set_tc_layer_text();
+  tc_show_time(hourStyled, currentTime->tm_min, currentTime->tm_sec);
 
+  if (units_changed & DAY_UNIT)
+  {
     strftime(dateStr, 17, "%A%n%b", currentTime);
     int dayStartOff = strlen(dateStr);
     snprintf(&(dateStr[dayStartOff]), 4, " %i",  currentTime->tm_mday);
@@ -892,266 +2632,386 @@ static void tc_handle_second_tick(struct tm *currentTime, TimeUnits units_change
 }
 
 
-// Time/chronometer window Mode button.
-static void tc_up_long_click_handler(ClickRecognizerRef recognizer, Window *window) {
+// Display time of day with every field redrawn, e.g. when switching from chrono.
+static void tc_show_clock_now()
+{
+  time_t now = time(NULL);
+  tc_show_clock(localtime(&now), SECOND_UNIT | MINUTE_UNIT | HOUR_UNIT | DAY_UNIT);
+}
 
-  selectedMode = (selectedMode + 1) % MODE_MAX;
 
-  // CHRONO mode
-  if (selectedMode == MODE_CHRON)
+// Tenths only change visibly while the running chronometer is on screen.
+static bool tc_fast_redraw_wanted()
+{
+  return selectedMode == MODE_CHRON &&
+         chrono_running() &&
+         resetInProgress == false &&
+         timeWindowVisible;
+}
+
+
+// Redraw chronometer at tenths resolution. Reschedules itself for the next tenth boundary.
+static void tc_fast_redraw_handler(void *callback_data)
+{
+  fastRedrawTimerHandle = NULL;
+
+  if (tc_fast_redraw_wanted())
   {
-    layer_set_hidden(bitmap_layer_get_layer(ssLayer), false);
+    tc_show_chrono();
 
-    strncpy(dateStr, "CHRONO", sizeof(dateStr));
-    text_layer_set_text(dateInfoLayer, dateStr);
+    fastRedrawTimerHandle = app_timer_register(FAST_REDRAW_MS - chrono_elapsed() % FAST_REDRAW_MS,
+                                               tc_fast_redraw_handler, NULL);
+  }
+}
 
-    if (chronoRunSelect == RUN_START)
-    {
-      // Splits buffer not full.
-      if (splitIndex < MAX_SPLIT_INDEX)
-      {
-        // Label split button wth next available split buffer slot number.
-        // splitIndex is set to last used, so increment by 2: 1 to make count + 1 to make next
-        snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s %i", SPLIT_TEXT, splitIndex + 2);
-      }
 
-      // Splits buffer is full.
-      else
-      {
-        // Mark full when keeping oldest splits.
-        //if (splitButtonBehavior == SPLITS_KEEP_OLDEST)
-        if (strcmp(splitsFullReplaceOldest, OPTION_CHOICE_NO) == 0)
-        {
-          snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s", SPLIT_TEXT_FULL);
-        }
+// Coarsest tick units the time window currently needs. Only the clock changes once per
+// second. A running chronometer is redrawn by the tenths timer, and a stopped one or a
+// covered window does not change at all. Chrono time does not depend on ticks.
+static TimeUnits tc_needed_tick_units()
+{
+  if (timeWindowVisible && selectedMode == MODE_CLOCK)
+  {
+    return SECOND_UNIT;
+  }
 
-        // Label with max split count when keeping latest splits.
-        else
-        {
-          snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s %i", SPLIT_TEXT, MAX_SPLIT_INDEX + 1);
-        }
-      }
+  return NO_TICK_UNITS;
+}
 
-      //strncpy(spt_rstButtonText, SPLIT_TEXT, sizeof(spt_rstButtonText));
-    }
-    else if ( ! chronoHasBeenReset)
+
+// Switch between tenths redraw, once per second tick redraw or no redraw based on what is on screen.
+static void tc_update_redraw_rate()
+{
+  layer_set_hidden(timeChronoFracLayer, selectedMode != MODE_CHRON);
+
+  TimeUnits neededUnits = tc_needed_tick_units();
+  if (neededUnits != tickUnits)
+  {
+    if (neededUnits == NO_TICK_UNITS)
     {
-      strncpy(spt_rstButtonText, RESET_TEXT, sizeof(spt_rstButtonText));
+      tick_timer_service_unsubscribe();
     }
-    // Blank when in reset state
     else
     {
-      strncpy(spt_rstButtonText, BLANK_TEXT, sizeof(spt_rstButtonText));
+      tick_timer_service_subscribe(neededUnits, tc_handle_second_tick);
     }
 
-    text_layer_set_text(sptRstButtonLayer, spt_rstButtonText);
+    tickUnits = neededUnits;
   }
 
-  // Switch to WATCH mode.
-  else
+  if (tc_fast_redraw_wanted())
   {
-    layer_set_hidden(bitmap_layer_get_layer(ssLayer), true);
+    if (fastRedrawTimerHandle == NULL)
+    {
+      tc_fast_redraw_handler(NULL);
+    }
+  }
+  else if (fastRedrawTimerHandle != NULL)
+  {
+    app_timer_cancel(fastRedrawTimerHandle);
+    fastRedrawTimerHandle = NULL;
+  }
+}
 
-    strncpy(spt_rstButtonText, OPTIONS_TEXT, sizeof(spt_rstButtonText));
-    text_layer_set_text(sptRstButtonLayer, spt_rstButtonText);
+
+// Used by time/chronometer window. Called once per second while the clock is on screen.
+// Chronometer time is derived from the wall clock and is redrawn by its own timer.
+static void tc_handle_second_tick(struct tm *currentTime, TimeUnits units_changed) 
+{
+  if (selectedMode == MODE_CLOCK)
+  {
+    tc_show_clock(currentTime, units_changed);
   }
 }
 
 
-// Time/chronometer window Start/Stop button
-static void tc_select_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
-  if (selectedMode == MODE_CHRON)
+// Split/reset button label for the current mode and chronometer state.
+// "splitNbr" is set to the next split number for SPT_RST_SPLIT.
+static SptRstLabel tc_spt_rst_label(int *splitNbr)
+{
+  if (selectedMode != MODE_CHRON)
   {
-    chronoRunSelect = (chronoRunSelect + 1) % RUN_MAX;
+    return SPT_RST_OPTIONS;
+  }
 
-    // Transitioned to running. Display Splits button.
-    if (chronoRunSelect == RUN_START)
-    {
-      //strncpy(spt_rstButtonText, SPLIT_TEXT, sizeof(spt_rstButtonText));
+  // Blank when in reset state
+  if ( ! chrono_running())
+  {
+    return chrono_has_been_reset() ? SPT_RST_BLANK : SPT_RST_RESET;
+  }
 
-      // Splits buffer not full.
-      if (splitIndex < MAX_SPLIT_INDEX)
-      {
-        // Label split button wth next available split buffer slot number.
-        // splitIndex is set to last used, so increment by 2: 1 to make count + 1 to make next
-        snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s %i", SPLIT_TEXT, splitIndex + 2);
-      }
+  // Mark full when keeping oldest splits.
+  const split_ring_S *ring = chrono_splits();
+  if (split_ring_full(ring) && ! settings_get(SETTING_REPLACE_OLDEST))
+  {
+    return SPT_RST_SPLIT_FULL;
+  }
 
-      // Splits buffer is full.
-      else
-      {
-        // Mark full when keeping oldest splits.
-        //if (splitButtonBehavior == SPLITS_KEEP_OLDEST)
-        if (strcmp(splitsFullReplaceOldest, OPTION_CHOICE_NO) == 0)
-        {
-          snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s", SPLIT_TEXT_FULL);
-        }
+  // Label split button with the number the next split takes, counting any replaced when full.
+  *splitNbr = ring->dropped + split_ring_count(ring) + 1;
+  return SPT_RST_SPLIT;
+}
 
-        // Label with max split count when keeping latest splits.
-        else
-        {
-          snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s %i", SPLIT_TEXT, MAX_SPLIT_INDEX + 1);
-        }
-      }
+
+// Label the split/reset button. Nothing is formatted or redrawn unless the label changed.
+static void tc_update_spt_rst_label()
+{
+  int splitNbr = 0;
+  SptRstLabel label = tc_spt_rst_label(&splitNbr);
+  if (label == shownSptRstLabel && splitNbr == shownSplitNbr)
+  {
+    return;
+  }
+
+  if (label == SPT_RST_SPLIT)
+  {
+    int width = 1;
+    for (int limit = 10; width < SPLIT_NBR_DIGITS && splitNbr >= limit; limit *= 10)
+    {
+      width++;
     }
-    // Transitioned to stopped. Display Reset button.
-    else
+    format_digits(&splitNbrText[SPLIT_NBR_OFFSET], splitNbr, width, '0');
+    splitNbrText[SPLIT_NBR_OFFSET + width] = '\0';
+  }
+
+  shownSptRstLabel = label;
+  shownSplitNbr = splitNbr;
+  text_layer_set_text(sptRstButtonLayer, SPT_RST_LABEL_TEXT[label]);
+}
+
+
+// Name of the selected chronometer, in the date label. CHRONO_COUNT is a single digit.
+static void tc_set_chrono_label()
+{
+  snprintf(dateStr, sizeof(dateStr), "CHRONO %c", '0' + (chrono_selected() + 1) % 10);
+}
+
+
+// Derive the date label from the restored state. Clock mode date is built on display.
+static void tc_restore_labels()
+{
+  if (selectedMode == MODE_CHRON)
+  {
+    tc_set_chrono_label();
+  }
+}
+
+
+// Chronometer model changed. Persist the change, then update what is on screen.
+// Labels and time are only formatted while they can be seen; the time window
+// brings itself up to date when it appears.
+static void tc_chrono_changed(ChronoChanges changes)
+{
+  if (changes & CHRONO_CHANGED_SPLITS_CLEARED)
+  {
+    persist_compact();
+
+    splitDisplayIndex = 0;
+    select_splits_display_content();
+  }
+  else if (changes & CHRONO_CHANGED_SPLIT_ADDED)
+  {
+    persist_journal_split(chrono_latest_split());
+  }
+  else
+  {
+    persist_journal_chrono();
+  }
+
+  if (timeWindowVisible && selectedMode == MODE_CHRON)
+  {
+    if (changes & (CHRONO_CHANGED_RUN | CHRONO_CHANGED_RESET))
     {
-      strncpy(spt_rstButtonText, RESET_TEXT, sizeof(spt_rstButtonText));
+      // Show start/stop graphic based on current run state.
+      tc_show_run_icon();
 
-      chronoHasBeenReset = false;
+      // Show exact time at transition, then redraw tenths only while running.
+      tc_show_chrono();
+      tc_update_redraw_rate();
     }
 
-    text_layer_set_text(sptRstButtonLayer, spt_rstButtonText);
-
-    // Redraw start/stop graphic based on current run state.
-    layer_mark_dirty((Layer*)ssLayer);
+    tc_update_spt_rst_label();
   }
 }
 
 
-// Set from time/chronometer window long DOWN click button handler.
-static void tc_reset_timeout_handler(void *callback_data) {
+// Apply queued presses to the chronometer.
+static void tc_input_drain()
+{
+  if (chrono_input_pending())
+  {
+    chrono_input_drain(settings_get(SETTING_REPLACE_OLDEST));
+  }
+}
 
-  chronoElapsed = 0;
-  text_layer_set_text(timeChronoHhmmLayer, " 0:00");
-  text_layer_set_text(timeChronoSecLayer, "00");
 
-  strncpy(spt_rstButtonText, BLANK_TEXT, sizeof(spt_rstButtonText));
-  text_layer_set_text(sptRstButtonLayer, spt_rstButtonText);
+static void tc_input_drain_handler(void *callback_data)
+{
+  inputDrainTimerHandle = NULL;
+  tc_input_drain();
+}
+
 
-  resetInProgress = false;
+// Queue a press for the selected chronometer. When the queue is full, the presses already
+// queued are applied first.
+static void tc_input_push(ChronoInputType type, int64_t atMs)
+{
+  if ( ! chrono_input_push(type, atMs))
+  {
+    tc_input_drain();
+    chrono_input_push(type, atMs);
+  }
 
-  // Reset splits buffer if the option is active.
-  if (strcmp(resetButtonClearsSplits, OPTION_CHOICE_YES) == 0)
+  if (inputDrainTimerHandle == NULL)
   {
-    splitIndex = SPLIT_INDEX_RESET;
+    inputDrainTimerHandle = app_timer_register(0, tc_input_drain_handler, NULL);
   }
 }
 
 
-// Time/chronometer window Split button. Must be displaying chrono and running.
-static void tc_down_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
-  //APP_LOG(APP_LOG_LEVEL_DEBUG, "entered tc_down_single_click_handler (split button)");
+// Time/chronometer window Mode button.
+static void tc_up_long_click_handler(ClickRecognizerRef recognizer, Window *window) {
+
+  tc_input_drain();
+
+  selectedMode = (selectedMode + 1) % MODE_MAX;
 
-  // CHRONO mode.
+  // CHRONO mode
   if (selectedMode == MODE_CHRON)
   {
-    // Process as split request if running.
-    if (chronoRunSelect == RUN_START)
-    {
-      // If full, determine behavior based on selected setting.
-      if (splitIndex == MAX_SPLIT_INDEX)
-      {
-        // If saving latest, throw away oldest to make room for new.
-        //if (splitButtonBehavior == SPLITS_KEEP_LATEST)
-        if (strcmp(splitsFullReplaceOldest, OPTION_CHOICE_YES) == 0)
-        {
-          for (int i = 1; i <= MAX_SPLIT_INDEX; i++)
-          {
-            splits[i - 1] = splits [i];
-          }
+    layer_set_hidden(bitmap_layer_get_layer(ssLayer), false);
 
-          splits[splitIndex] = chronoElapsed;
-        }
-        // else - saving oldest so throw request away this request
-      }
+    tc_set_chrono_label();
+    text_layer_set_text(dateInfoLayer, dateStr);
 
-      // Buffer is not full.
-      else
-      {
-        splitIndex++;
-        splits[splitIndex] = chronoElapsed;
+    tc_show_chrono();
+  }
 
-        // If split buffer is now full, determine how to update splits button label.
-        if (splitIndex == MAX_SPLIT_INDEX)
-        {
-          // If we're saving the oldest, set label to indicate splits buffer is now full.
-          //if (splitButtonBehavior == SPLITS_KEEP_OLDEST)
-          if (strcmp(splitsFullReplaceOldest, OPTION_CHOICE_NO) == 0)
-          {
-            snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s", SPLIT_TEXT_FULL);
-          }
+  // Switch to WATCH mode.
+  else
+  {
+    layer_set_hidden(bitmap_layer_get_layer(ssLayer), true);
 
-          // We're saving latest, so set label to indicate last slot number.
-          else
-          {
-            snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s %i", SPLIT_TEXT, splitIndex + 1);
-          }
-        }
+    tc_show_clock_now();
+  }
 
-        // Splits buffer is not full, update split button label to reflect next available slot.
-        // splitIndex is set to last used, so increment by 2: 1 to make count + 1 to make next
-        else
-        {
-          snprintf(spt_rstButtonText, sizeof(spt_rstButtonText), "%s %i", SPLIT_TEXT, splitIndex + 2);
-        }
+  tc_update_spt_rst_label();
+  tc_update_redraw_rate();
+}
+
+
+// Time/chronometer window UP button. Shows the next chronometer. Only the one on screen is
+// redrawn; the others keep running from their own start times.
+static void tc_up_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+
+  if (selectedMode != MODE_CHRON || resetInProgress)
+  {
+    return;
+  }
+
+  // Queued presses belong to the chronometer they were made on.
+  tc_input_drain();
+  chrono_select((chrono_selected() + 1) % CHRONO_COUNT);
+  splitPressMs = SPLIT_PRESS_NONE;
+
+  tc_set_chrono_label();
+  text_layer_set_text(dateInfoLayer, dateStr);
+
+  tc_show_run_icon();
+  tc_show_chrono();
+  tc_update_spt_rst_label();
+  tc_update_redraw_rate();
+}
+
+
+// Time/chronometer window Start/Stop button
+static void tc_select_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+  if (selectedMode == MODE_CHRON)
+  {
+    tc_input_push(CHRONO_INPUT_TOGGLE_RUN, chrono_now_ms());
+  }
+}
+
+
+// Set from time/chronometer window long DOWN click button handler.
+static void tc_reset_timeout_handler(void *callback_data) {
+
+  resetTimerHandle = NULL;
+  resetInProgress = false;
+
+  // Reset splits buffer too if the option is active, keeping them as a saved session.
+  if (settings_get(SETTING_RESET_CLEARS_SPLITS))
+  {
+    session_store_archive();
+  }
+  chrono_reset(settings_get(SETTING_RESET_CLEARS_SPLITS));
+}
 
-        // Update the display.
-        text_layer_set_text(sptRstButtonLayer, spt_rstButtonText);
-      }
-    }
 
-    // else - Ignore CHRONO mode if not running
+// Time/chronometer window Split button. Must be displaying chrono and running.
+static void tc_down_single_click_handler(ClickRecognizerRef recognizer, Window *window) {
+  //APP_LOG(APP_LOG_LEVEL_DEBUG, "entered tc_down_single_click_handler (split button)");
+
+  // CHRONO mode. Split is ignored if not running, or if full and saving the oldest.
+  if (selectedMode == MODE_CHRON)
+  {
+    tc_input_push(CHRONO_INPUT_SPLIT, (splitPressMs != SPLIT_PRESS_NONE) ? splitPressMs : chrono_now_ms());
+    splitPressMs = SPLIT_PRESS_NONE;
   }
 
   // WATCH mode
   else
   {
     // Display options menu.
-    window_stack_push(menu_window, true /* Animated */);
+    menu_window_push();
   }
 }
 
 
-// Time/chronometer window Reset button pressed. Must be displaying chrono, not running, and needing to be reset.
+// Time/chronometer window Split/Reset button pressed. This is the moment of any split. A reset
+// must be displaying chrono, not running, and needing to be reset.
 static void tc_down_down_handler(ClickRecognizerRef recognizer, Window *window) {
 
+  // Timestamp the press. It is a split if the click is recognized and the chronometer is
+  // running when the queue is applied.
+  if (selectedMode == MODE_CHRON)
+  {
+    splitPressMs = chrono_now_ms();
+
+    // A start may still be queued. Splits queued while running are left for the drain.
+    if ( ! chrono_running())
+    {
+      tc_input_drain();
+    }
+  }
+
   // Must be displaying chrono, not running, and needing to be reset.
-  if (selectedMode == MODE_CHRON && chronoRunSelect == RUN_STOP && ( ! chronoHasBeenReset))
+  if (selectedMode == MODE_CHRON && ( ! chrono_running()) && ( ! chrono_has_been_reset()))
   {
     resetTimerHandle = app_timer_register(1000, tc_reset_timeout_handler, NULL);
 
-    strcpy(savedChronoHhmm, text_layer_get_text(timeChronoHhmmLayer));
-    strcpy(savedChronoSec, text_layer_get_text(timeChronoSecLayer));
-    text_layer_set_text(timeChronoHhmmLayer, "HOLD");
-    text_layer_set_text(timeChronoSecLayer, "");
-    savedChronoElapsed = chronoElapsed;
+    digit_layer_set_text(timeChronoHhmmLayer, "HOLD");
+    digit_layer_set_text(timeChronoSecLayer, "");
+    digit_layer_set_text(timeChronoFracLayer, "");
+    tc_forget_shown_time();
 
     resetInProgress = true;
   }
 }
 
 
-// Time/chronometer window Reset button released. Must be displaying chrono, not running, and needing to be reset.
+// Time/chronometer window Reset button released. If the reset timeout has not fired yet, abort the reset.
 static void tc_down_up_handler(ClickRecognizerRef recognizer, Window *window) {
 
-  // Must be displaying chrono, not running, and needing to be reset.
-  if (selectedMode == MODE_CHRON && chronoRunSelect == RUN_STOP && ( ! chronoHasBeenReset))
+  // Button released before reset timeout completed - abort reset!
+  // Chronometer has not been cleared yet, only the display needs restoring.
+  if (resetInProgress)
   {
-    // Reset timeout fired, meaning we proceed with the reset.
-    if (resetInProgress == false)
-    {
-      //chronoElapsed = 0;
-      //text_layer_set_text(timeChronoHhmmLayer, " 0:00:00");
-
-      //strncpy(spt_rstButtonText, BLANK_TEXT, sizeof(spt_rstButtonText));
-      //text_layer_set_text(sptRstButtonLayer, spt_rstButtonText);
-
-      chronoHasBeenReset = true;
-    }
-    // Button released before reset timeout completed - abort reset!
-    else
-    {
-      text_layer_set_text(timeChronoHhmmLayer, savedChronoHhmm);
-      text_layer_set_text(timeChronoSecLayer, savedChronoSec);
-      chronoElapsed = savedChronoElapsed;
-
-      app_timer_cancel(resetTimerHandle);
-      resetTimerHandle = NULL;
-    }
-
     resetInProgress = false;
+    tc_show_chrono();
+
+    app_timer_cancel(resetTimerHandle);
+    resetTimerHandle = NULL;
   }
 }
 
@@ -1160,6 +3020,7 @@ static void tc_down_up_handler(ClickRecognizerRef recognizer, Window *window) {
 static void tc_click_config_provider(Window *window) {
   //APP_LOG(APP_LOG_LEVEL_DEBUG, "entered tc_click_config_provider");
 
+  window_single_click_subscribe(BUTTON_ID_UP, (ClickHandler) tc_up_single_click_handler);
   window_long_click_subscribe(BUTTON_ID_UP, 300, (ClickHandler) tc_up_long_click_handler, NULL);
 
   window_single_click_subscribe(BUTTON_ID_SELECT, (ClickHandler) tc_select_single_click_handler);
@@ -1176,187 +3037,43 @@ NULL);
 static void app_init() {
   
   // ### Restore state if exists. ###
-  if (persist_exists(persistent_data_key))
-  {
-    saved_state_S saved_state;
-    int bytes_read = 0;
-    if (sizeof(saved_state_S) == (bytes_read = persist_read_data(persistent_data_key,
-                                                                 (void *)&saved_state,
-                                                                 sizeof(saved_state_S))))
-    {
-      //(APP_LOG_LEVEL_DEBUG, "read state: selectedMode: %i, chronoRunSelect: %i, closeTm: %i",
-      //                             saved_state.selectedMode,
-      //                             saved_state.chronoRunSelect,
-      //                             (int)saved_state.closeTm);
-
-      // Chronometer time that elapsed while app was not running.
-      time_t timeSinceClosed = 0;
-      if (saved_state.chronoRunSelect == RUN_START)
-      {
-        timeSinceClosed = time(NULL) - saved_state.closeTm;
-        //APP_LOG(APP_LOG_LEVEL_DEBUG, "timeSinceClosed: %i", (int)timeSinceClosed);
-      }
-
-      selectedMode = saved_state.selectedMode;
-      strncpy(timeText, saved_state.timeText, sizeof(timeText));
-      strncpy(dateStr, saved_state.dateStr, sizeof(dateStr)); 
-      chronoRunSelect = saved_state.chronoRunSelect;
-      chronoElapsed = saved_state.chronoElapsed + timeSinceClosed;
-      strncpy(spt_rstButtonText, saved_state.spt_rstButtonText, sizeof(spt_rstButtonText));
-      chronoHasBeenReset = saved_state.chronoHasBeenReset;
-      //for (int i = 0; i <= MAX_SPLIT_INDEX; i++)
-      strncpy(resetButtonClearsSplits, saved_state.resetButtonClearsSplits, sizeof(resetButtonClearsSplits));
-      strncpy(splitsFullReplaceOldest, saved_state.splitsFullReplaceOldest, sizeof(splitsFullReplaceOldest));
-      strncpy(colorInversionChoice, saved_state.colorInversionChoice, sizeof(colorInversionChoice));
-      #ifdef PBL_COLOR
-      colorSelectChoice = saved_state.colorSelectChoice;
-      #endif
-
-      // Get saved extended splits before restoring all splits.
-      if (persist_exists(extended_splits_key))
-      {
-        saved_splits_S saved_splits;
-        int bytes_read = 0;
-        if (sizeof(saved_splits_S) == (bytes_read = persist_read_data(extended_splits_key,
-                                                                     (void *)&saved_splits,
-                                                                     sizeof(saved_splits_S))))
-        {
-          for (int i = 0; i < BASE_SPLIT_CNT; i++)
-          {
-            splits[i] = saved_state.splits[i];
-          }
-
-
-          for (int i = 0; i < EXTENDED_SPLIT_CNT; i++)
-          {
-            splits[BASE_SPLIT_CNT + i] = saved_splits.splits[i];
-          }
-
-          splitIndex = saved_state.splitIndex;
-        }
+  chrono_init();
+  persist_restore_state();
+  persist_replay_journal();
+  session_store_load();
+  tc_restore_labels();
+  chrono_set_change_handler(tc_chrono_changed);
+  settings_set_change_handler(option_setting_changed);
 
-        // Fill in undefined fields if error reading persistent data.
-        else
-        {
-          APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_read_data(saved_splits). bytes read = %i", bytes_read);
-          for (int i = 0; i <= MAX_SPLIT_INDEX; i++)
-          {
-            splits[i] = 0;
-          }
-        }
-      }
-
-      // Fill in undefined fields if persistent data does not exit.
-      else
-      {
-        APP_LOG(APP_LOG_LEVEL_DEBUG, "persist_exists(saved_splits) returned false");
-        for (int i = 0; i <= MAX_SPLIT_INDEX; i++)
-        {
-          splits[i] = 0;
-        }
-      }
-    }
-
-    // Fill in undefined fields if error reading persistent data.
-    else
-    {
-      APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_read_data(saved_state). bytes read = %i", bytes_read);
-      for (int i = 0; i <= MAX_SPLIT_INDEX; i++)
-      {
-        splits[i] = 0;
-      }
-
-      strncpy(spt_rstButtonText, OPTIONS_TEXT, sizeof(spt_rstButtonText));
-    }
-  }
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "persistent data restore complete");
 
-  // Fill in undefined fields if persistent data does not exist.
-  else
+  // Glyphs for time and chronometer, and the date font.
+  hhmmAtlas = digit_atlas_create(resource_get_handle(RESOURCE_ID_FONT_UNIVERS_COND_MED_46), HHMM_GLYPHS, 46);
+  secAtlas = digit_atlas_create(resource_get_handle(RESOURCE_ID_FONT_UNIVERS_COND_MED_24), SEC_GLYPHS, 26);
+  if (hhmmAtlas == NULL || secAtlas == NULL)
   {
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "persist_exists(saved_state) returned false");
-    for (int i = 0; i <= MAX_SPLIT_INDEX; i++)
-    {
-      splits[i] = 0;
-    }
-
-    strncpy(spt_rstButtonText, OPTIONS_TEXT, sizeof(spt_rstButtonText));
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "no memory for digit atlas, drawing time with system fonts");
   }
-
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "persistent data restore complete");
-
-  // Fonts for time and chronometer.
-  hhmm_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_UNIVERS_COND_MED_46));
-  sec_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_UNIVERS_COND_MED_24));
-
-  // Get graphics.
-  menuIcon = gbitmap_create_with_resource(RESOURCE_ID_MENU_IMAGE);
-  up_image = gbitmap_create_with_resource(RESOURCE_ID_UP_ICON);
-  dn_image = gbitmap_create_with_resource(RESOURCE_ID_DN_ICON);
+  date_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_UNIVERS_COND_MED_24));
 
   // SDK 3.0 support for color ionversion.
   #ifdef PBL_COLOR
-    colorDark = colorSelectColor[colorSelectChoice];
+    colorDark = palette_color(settings_color_select());
   #else
     colorDark = GColorBlack;
   #endif
 
-  // ### Menu window setup. ###
-  menu_window = window_create();
-  Layer * menu_window_layer = window_get_root_layer(menu_window);
-  window_set_fullscreen(menu_window, true);
-
-  menuItems[0] = (SimpleMenuItem){.title = "Display Splits",
-                                  .subtitle = NULL,
-                                  .callback = menuDisplaySplitsHandler,
-                                  .icon = NULL};
-  menuItems[1] = (SimpleMenuItem){.title = "Clear Splits",
-                                  .subtitle = NULL,
-                                  .callback = menuClearSplitsHandler,
-                                  .icon = NULL};
-  menuItems[2] = (SimpleMenuItem){.title = "Splits Option",
-                                  .subtitle = NULL,
-                                  .callback = menuSplitsOptionHandler,
-                                  .icon = NULL};
-  menuItems[3] = (SimpleMenuItem){.title = "Reset Option",
-                                  .subtitle = NULL,
-                                  .callback = menuResetOptionHandler,
-                                  .icon = NULL};
-  menuItems[4] = (SimpleMenuItem){.title = "Color Inversion",
-                                  .subtitle = NULL,
-                                  .callback = menuColorInversionHandler,
-                                  .icon = NULL};
-  #ifdef PBL_COLOR
-  menuItems[5] = (SimpleMenuItem){.title = "Color Select",
-                                  .subtitle = NULL,
-                                  .callback = menuColorSelectHandler,
-                                  .icon = NULL};
-  #endif
-  menuItems[NBR_MENU_ITEMS - 1] = (SimpleMenuItem){.title = APP_VERSION,
-                                  .subtitle = NULL,
-                                  .callback = NULL,
-                                  .icon = NULL};
-
-  menuSection[0] = (SimpleMenuSection){.items = menuItems, .num_items = NBR_MENU_ITEMS, .title = NULL};
-
-  menuLayer = simple_menu_layer_create(layer_get_bounds(menu_window_layer),
-                                       menu_window,
-                                       menuSection,
-                                       1,
-                                       NULL);
-
-  simple_menu_layer_set_selected_index(menuLayer, 0, true);
-  layer_add_child(menu_window_layer, simple_menu_layer_get_layer(menuLayer));
-
   // ### Time/chronometer window setup ###
 
   // Time/chrono window setup.
+  clock_is_24h = clock_is_24h_style();
   time_window = window_create();
   Layer * time_window_layer = window_get_root_layer(time_window);
   window_set_fullscreen(time_window, true);
 
   // Light icon area
+  lightIcon = icon_create(LIGHT_ICON_SIZE);
   lightLayer = bitmap_layer_create(GRect(82, 4, 16, 16));
-  layer_set_update_proc((Layer*)lightLayer, tc_lightLayer_update_proc);
   layer_add_child(time_window_layer, bitmap_layer_get_layer(lightLayer));
 
   // Mode button
@@ -1368,25 +3085,28 @@ static void app_init() {
 
   // Time/chronograph area - Hours & Minutes
   // 2.1.1 timeChronoHhmmLayer = text_layer_create(GRect(0, 55, 102, 46));
-  timeChronoHhmmLayer = text_layer_create(GRect(0, 48, 102, 46));
-  text_layer_set_text_alignment(timeChronoHhmmLayer, GTextAlignmentRight);
-  text_layer_set_font(timeChronoHhmmLayer, hhmm_font);
+  timeChronoHhmmLayer = digit_layer_create(GRect(0, 48, 102, 46), hhmmAtlas,
+                                           fonts_get_system_font(FONT_KEY_BITHAM_42_BOLD), GTextAlignmentRight);
 
   // Time/chronograph area - Seconds
-  timeChronoSecLayer = text_layer_create(GRect(104, 64, 26, 26));
-  text_layer_set_text_alignment(timeChronoSecLayer, GTextAlignmentLeft);
-  text_layer_set_font(timeChronoSecLayer, sec_font);
+  timeChronoSecLayer = digit_layer_create(GRect(104, 64, 26, 26), secAtlas,
+                                          fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD), GTextAlignmentLeft);
+
+  // Time/chronograph area - Tenths, above seconds. Chrono mode only.
+  timeChronoFracLayer = digit_layer_create(GRect(104, 40, 26, 26), secAtlas,
+                                           fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD), GTextAlignmentLeft);
+  digit_layer_set_text(timeChronoFracLayer, chronoFracText);
+  layer_set_hidden(timeChronoFracLayer, selectedMode != MODE_CHRON);
 
   // Time/chronograph area - common
-  tc_set_tc_layer_text();
-  layer_add_child(time_window_layer, text_layer_get_layer(timeChronoHhmmLayer));
-  layer_add_child(time_window_layer, text_layer_get_layer(timeChronoSecLayer));
+  layer_add_child(time_window_layer, timeChronoHhmmLayer);
+  layer_add_child(time_window_layer, timeChronoSecLayer);
+  layer_add_child(time_window_layer, timeChronoFracLayer);
 
   // Start/stop area
+  startIcon = icon_create(SS_ICON_SIZE);
+  stopIcon = icon_create(SS_ICON_SIZE);
   ssLayer = bitmap_layer_create(GRect(130, 67, 14, 30));
-  layer_set_update_proc((Layer*)ssLayer, tc_ssLayer_update_proc);
-  startIconP = gpath_create(&START_PATH_INFO);
-  stopIconP = gpath_create(&STOP_PATH_INFO);
   layer_add_child(time_window_layer, bitmap_layer_get_layer(ssLayer));
   if (selectedMode == MODE_CHRON)
   {
@@ -1400,124 +3120,38 @@ static void app_init() {
   // dateStr/info area
   dateInfoLayer = text_layer_create(GRect(10, 94, 120, 52));
   text_layer_set_text_alignment(dateInfoLayer, GTextAlignmentCenter);
-  text_layer_set_font(dateInfoLayer, sec_font);
+  text_layer_set_font(dateInfoLayer, date_font);
   text_layer_set_text(dateInfoLayer, dateStr);
   layer_add_child(time_window_layer, text_layer_get_layer(dateInfoLayer));
 
+  // Time/chronograph area - initial display.
+  if (selectedMode == MODE_CHRON)
+  {
+    tc_show_chrono();
+  }
+  else
+  {
+    tc_show_clock_now();
+  }
+
   // Split/Reset button
   sptRstButtonLayer = text_layer_create(GRect(0, 146, 142, 20));
   text_layer_set_text_alignment(sptRstButtonLayer, GTextAlignmentRight);
   text_layer_set_font(sptRstButtonLayer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-  text_layer_set_text(sptRstButtonLayer, spt_rstButtonText);
+  tc_update_spt_rst_label();
   layer_add_child(time_window_layer, text_layer_get_layer(sptRstButtonLayer));
 
   //tc_set_color();
   // Hook to call tc_set_color(). Allows it to be called just once on exit from color select.
-  window_set_window_handlers(time_window, (WindowHandlers){.appear = timeAppearHandler});
+  // Disappear hook stops tenths redraw while covered by another window.
+  window_set_window_handlers(time_window, (WindowHandlers){.appear = timeAppearHandler,
+                                                           .disappear = timeDisappearHandler});
 
   window_set_click_config_provider(time_window, (ClickConfigProvider) tc_click_config_provider);
 
-  clock_is_24h = clock_is_24h_style();
-  
-  // Start keeping track of time/chrono elapsed.
-  tick_timer_service_subscribe(SECOND_UNIT, tc_handle_second_tick);
-
-  // ### Splits window setup ###
-
-  // Create splits window.
-  split_window = window_create();
-  Layer * split_window_layer = window_get_root_layer(split_window);
-  window_set_fullscreen(split_window, true);
-  window_set_background_color(split_window, GColorBlack);
-
-  // Title
-  splitTitleLayer = text_layer_create(GRect(0, 0, 144, 28));
-  text_layer_set_text_alignment(splitTitleLayer, GTextAlignmentCenter);
-  text_layer_set_font(splitTitleLayer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_background_color(splitTitleLayer, GColorWhite);
-  text_layer_set_text_color(splitTitleLayer, GColorBlack);
-  text_layer_set_text(splitTitleLayer, "Splits");
-  layer_add_child(split_window_layer, text_layer_get_layer(splitTitleLayer));
-
-  // UP icon
-  splitUpIconLayer = bitmap_layer_create(GRect(129, 4, 15, 15));
-  bitmap_layer_set_bitmap(splitUpIconLayer, up_image);
-  layer_add_child(split_window_layer, bitmap_layer_get_layer(splitUpIconLayer));
-
-  // Splits content
-  splitContentLayer = text_layer_create(GRect(0, 32, 144, 136));
-  text_layer_set_text_alignment(splitContentLayer, GTextAlignmentCenter);
-  text_layer_set_font(splitContentLayer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_background_color(splitContentLayer, GColorWhite);
-  text_layer_set_text_color(splitContentLayer, GColorBlack);
-  text_layer_set_text(splitContentLayer, splitsDisplayContent);
-  layer_add_child(split_window_layer, text_layer_get_layer(splitContentLayer));
-
-  // DOWN icon
-  splitDnIconLayer = bitmap_layer_create(GRect(129, 157, 15, 15));
-  bitmap_layer_set_bitmap(splitDnIconLayer, dn_image);
-  layer_add_child(split_window_layer, bitmap_layer_get_layer(splitDnIconLayer));
-
-  window_set_click_config_provider(split_window, (ClickConfigProvider) splits_click_config_provider);
-
-  // ### Option window setup ###
-
-  // Create option window.
-  option_window = window_create();
-  Layer * option_window_layer = window_get_root_layer(option_window);
-  window_set_fullscreen(option_window, true);
-  window_set_background_color(option_window, GColorWhite);
-
-  // Up button label - "Yes"
-  optionUpLabelLayer = text_layer_create(GRect(0, 0, 142, 28));
-  text_layer_set_text_alignment(optionUpLabelLayer, GTextAlignmentRight);
-  text_layer_set_font(optionUpLabelLayer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_background_color(optionUpLabelLayer, GColorWhite);
-  text_layer_set_text_color(optionUpLabelLayer, GColorBlack);
-  text_layer_set_text(optionUpLabelLayer, OPTION_CHOICE_YES);
-  layer_add_child(option_window_layer, text_layer_get_layer(optionUpLabelLayer));
-
-  // Option content
-  optionContentLayer = text_layer_create(GRect(4, 32, 136, 136));
-  text_layer_set_text_alignment(optionContentLayer, GTextAlignmentCenter);
-  text_layer_set_font(optionContentLayer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_background_color(optionContentLayer, GColorWhite);
-  text_layer_set_text_color(optionContentLayer, GColorBlack);
-  text_layer_set_text(optionContentLayer, "test");
-  layer_add_child(option_window_layer, text_layer_get_layer(optionContentLayer));
-
-  // Down button label - "No"
-  optionDownLabelLayer = text_layer_create(GRect(0, 141, 142, 26));
-  text_layer_set_text_alignment(optionDownLabelLayer, GTextAlignmentRight);
-  text_layer_set_font(optionDownLabelLayer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_background_color(optionDownLabelLayer, GColorWhite);
-  text_layer_set_text_color(optionDownLabelLayer, GColorBlack);
-  text_layer_set_text(optionDownLabelLayer, OPTION_CHOICE_NO);
-  layer_add_child(option_window_layer, text_layer_get_layer(optionDownLabelLayer));
-
-  #ifdef PBL_COLOR
-  colorSelectColor[0] = GColorFromRGB(0, 0, 0);     // black
-  colorSelectColor[1] = GColorFromRGB(255, 0, 0);     // red
-  colorSelectColor[2] = GColorFromRGB(255, 128, 128);
-  colorSelectColor[3] = GColorFromRGB(128, 0, 0);
-  colorSelectColor[4] = GColorFromRGB(192, 96, 0);   // orange
-  colorSelectColor[5] = GColorFromRGB(255, 128, 0);
-  colorSelectColor[6] = GColorFromRGB(128, 64, 0);
-  colorSelectColor[7] = GColorFromRGB(0, 0, 255);     // blue
-  colorSelectColor[8] = GColorFromRGB(128, 128, 255);
-  colorSelectColor[9] = GColorFromRGB(0, 0, 128);
-  colorSelectColor[10] = GColorFromRGB(0, 255, 0);     // green
-  colorSelectColor[11] = GColorFromRGB(128, 255, 128);
-  colorSelectColor[12] = GColorFromRGB(0, 128, 0);
-  colorSelectColor[13] = GColorFromRGB(128, 0, 128);   // purple
-  colorSelectColor[14] = GColorFromRGB(255, 0, 255);
-  colorSelectColor[15] = GColorFromRGB(96, 0, 96);
-  #endif
-
-  // Note: window_set_click_config_provider() for option window will be set based on option selected.
+  // Tick subscription follows what is on screen, starting when the time window appears.
 
-  // Hook to restore button labels, etc, that may need to be modified by some menu items.
-  window_set_window_handlers(menu_window, (WindowHandlers){.appear = menuAppearHandler});
+  // Menu, splits and option windows are created when first pushed.
 
   window_stack_push(time_window, true /* Animated */);
 }
@@ -1525,69 +3159,17 @@ static void app_init() {
 
 static void app_deinit() {
 
-  // Save state.
-  saved_state_S saved_state;
-  saved_state.selectedMode = selectedMode;
-  strncpy(saved_state.timeText, timeText, sizeof(saved_state.timeText));
-  strncpy(saved_state.dateStr, dateStr, sizeof(saved_state.dateStr)); 
-  saved_state.chronoRunSelect = chronoRunSelect;
-  saved_state.chronoElapsed = chronoElapsed;
-  saved_state.closeTm = time(NULL);
-  strncpy(saved_state.spt_rstButtonText, spt_rstButtonText, sizeof(saved_state.spt_rstButtonText)); 
-  saved_state.chronoHasBeenReset = chronoHasBeenReset;
-  for (int i = 0; i < BASE_SPLIT_CNT; i++)
-  {
-    saved_state.splits[i] = splits[i];
-  }
-  saved_state.splitIndex = splitIndex;
-  strncpy(saved_state.resetButtonClearsSplits, resetButtonClearsSplits, sizeof(saved_state.resetButtonClearsSplits));
-  strncpy(saved_state.splitsFullReplaceOldest, splitsFullReplaceOldest, sizeof(saved_state.splitsFullReplaceOldest));
-  strncpy(saved_state.colorInversionChoice, colorInversionChoice, sizeof(saved_state.colorInversionChoice));
-  #ifdef PBL_COLOR
-  saved_state.colorSelectChoice = colorSelectChoice;
-  #endif
-
-  int bytes_written = 0;
-  if (sizeof(saved_state_S) != (bytes_written = persist_write_data(persistent_data_key,
-                                                                   (void *)&saved_state,
-                                                                   sizeof(saved_state_S))))
-  {  
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_write_data(saved_state). bytes written = %i", bytes_written);
-
-    // Delete all peristent data when a problem has occurred saving any of it.
-    persist_delete(extended_splits_key);
-    persist_delete(persistent_data_key);
-  }
-  else
+  // Apply presses not yet applied, then save state, folding any journaled splits into the base data.
+  if (inputDrainTimerHandle != NULL)
   {
-    //APP_LOG(APP_LOG_LEVEL_DEBUG, "write state: selectedMode: %i, chronoRunSelect: %i, closeTm: %i",
-    //                             saved_state.selectedMode,
-    //                             saved_state.chronoRunSelect,
-    //                             (int)saved_state.closeTm);
-
-    // Save extended splits.
-    saved_splits_S saved_splits;
-    for (int i = 0; i < EXTENDED_SPLIT_CNT; i++)
-    {
-      saved_splits.splits[i] = splits[BASE_SPLIT_CNT + i];
-    }
-
-    bytes_written = 0; 
-    if (sizeof(saved_splits_S) != (bytes_written = persist_write_data(extended_splits_key,
-                                                                     (void *)&saved_splits,
-                                                                     sizeof(saved_splits_S))))
-    {
-      APP_LOG(APP_LOG_LEVEL_DEBUG, "error during persist_write_data(extended_splits). bytes written = %i", bytes_written);
-
-      // Delete all peristent data when a problem has occurred saving any of it.
-      persist_delete(extended_splits_key);
-      persist_delete(persistent_data_key);
-    }
-    else
-    {
-      APP_LOG(APP_LOG_LEVEL_DEBUG, "all state data saved");
-    }
+    app_timer_cancel(inputDrainTimerHandle);
   }
+  tc_input_drain();
+  persist_compact();
+
+  // No more time window appear/disappear handling: destroying the windows would otherwise
+  // run it against timers and layers already released below.
+  window_set_window_handlers(time_window, (WindowHandlers){0});
 
   // Stop reset timer if running.
   if (resetTimerHandle != NULL)
@@ -1596,21 +3178,34 @@ static void app_deinit() {
     app_timer_cancel(resetTimerHandle);
   }
 
-  // Stop keeping track of time/chrono elapsed.
-  tick_timer_service_unsubscribe();
+  // Stop tenths redraw timer if running.
+  if (fastRedrawTimerHandle != NULL)
+  {
+    app_timer_cancel(fastRedrawTimerHandle);
+  }
 
-  // Destroy option window.
-  text_layer_destroy(optionContentLayer);
-  text_layer_destroy(optionUpLabelLayer);
-  text_layer_destroy(optionDownLabelLayer);
-  window_destroy(option_window);
+  // Stop ticks if still subscribed.
+  if (tickUnits != NO_TICK_UNITS)
+  {
+    tick_timer_service_unsubscribe();
+  }
 
-  // Destroy splits window.
-  bitmap_layer_destroy(splitDnIconLayer);
-  text_layer_destroy(splitContentLayer);
-  bitmap_layer_destroy(splitUpIconLayer);
-  text_layer_destroy(splitTitleLayer);
-  window_destroy(split_window);
+  // Destroy option, splits and session windows if they were ever pushed. Any still loaded are unloaded,
+  // destroying their layers.
+  if (option_window != NULL)
+  {
+    window_destroy(option_window);
+  }
+
+  if (split_window != NULL)
+  {
+    window_destroy(split_window);
+  }
+
+  if (session_window != NULL)
+  {
+    window_destroy(session_window);
+  }
 
   // Destroy time/chrono window.
   //if (tcInverterLayer != 0)
@@ -1620,24 +3215,30 @@ static void app_deinit() {
   //}
   bitmap_layer_destroy(lightLayer);
   text_layer_destroy(modeButtonLayer);
-  text_layer_destroy(timeChronoSecLayer);
-  text_layer_destroy(timeChronoHhmmLayer);
+  digit_layer_destroy(timeChronoSecLayer);
+  digit_layer_destroy(timeChronoFracLayer);
+  digit_layer_destroy(timeChronoHhmmLayer);
   text_layer_destroy(dateInfoLayer);
   bitmap_layer_destroy(ssLayer);
   text_layer_destroy(sptRstButtonLayer);
   window_destroy(time_window);
 
-  // Destroy menu window.
-  //APP_LOG(APP_LOG_LEVEL_DEBUG, "before menu destroy");
   //gbitmap_destroy(light_image);
-  gbitmap_destroy(menuIcon);
   //gbitmap_destroy(ss_image);
-  gpath_destroy(startIconP);
-  gpath_destroy(stopIconP);
-  gbitmap_destroy(up_image);
-  gbitmap_destroy(dn_image);
-  simple_menu_layer_destroy(menuLayer);
-  window_destroy(menu_window);
+  icon_destroy(startIcon);
+  icon_destroy(stopIcon);
+  icon_destroy(lightIcon);
+
+  digit_atlas_destroy(hhmmAtlas);
+  digit_atlas_destroy(secAtlas);
+  fonts_unload_custom_font(date_font);
+
+  // Destroy menu window if it was ever pushed.
+  //APP_LOG(APP_LOG_LEVEL_DEBUG, "before menu destroy");
+  if (menu_window != NULL)
+  {
+    window_destroy(menu_window);
+  }
 }
 
 
@@ -0,0 +1,572 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// Chronometer and splits model. See chrono.h.
+
+#include "pebble.h"
+#include "chrono.h"
+
+// Each chronometer is kept as the wall clock time of its latest start plus the time
+// accumulated by earlier runs. Elapsed time is computed on demand from these, so the
+// tick handler only redraws and a late or missed tick cannot cause drift. Chronometers
+// that are not selected cost nothing while they run.
+typedef struct chrono_S
+{
+  short runSelect;
+  int64_t startMs;      // Wall clock time (ms) of the latest start. Valid while running.
+  uint32_t accumulated; // Elapsed ms prior to the latest start, or zero if reset.
+
+  // "true" if the chronometer has been reset after being stopped.
+  // (i.e. do not need to display RESET text on a stopped and reset chronometer)
+  bool hasBeenReset;
+
+  // Wall clock time (ms) of the first start since the latest reset, or zero if not started since.
+  int64_t runStartMs;
+
+  // Splits. The first chronometer's ring is static. The others are smaller, allocated on their
+  // first split and freed when their splits are cleared, so unused chronometers hold no splits memory.
+  split_ring_S *ring;
+  lap_stats_S lapStats;
+} chrono_S;
+
+static uint32_t firstTimes[MAX_SPLITS];
+static split_ring_S firstRing;
+
+// Splits of a chronometer that has none allocated.
+static const split_ring_S emptyRing = {.capacity = OTHER_MAX_SPLITS};
+
+static chrono_S chronos[CHRONO_COUNT];
+static chrono_S *chrono = &chronos[0];
+
+static ChronoChangeHandler changeHandler = NULL;
+
+// Input events, queued by the button handlers and applied by chrono_input_drain(). Both run on
+// the app's single event loop, one after the other.
+typedef struct chrono_input_S
+{
+  ChronoInputType type;
+  int64_t atMs; // Wall clock time (ms) of the press.
+} chrono_input_S;
+
+static chrono_input_S inputs[CHRONO_INPUT_MAX];
+static uint8_t inputHead = 0; // Next slot to write.
+static uint8_t inputTail = 0; // Next slot to read.
+
+
+// Start each chronometer stopped and reset. Call once before any other chrono_ function.
+void chrono_init()
+{
+  for (int i = 0; i < CHRONO_COUNT; i++)
+  {
+    chronos[i].runSelect = RUN_STOP;
+    chronos[i].hasBeenReset = true;
+  }
+
+  split_ring_init(&firstRing, firstTimes, MAX_SPLITS);
+  chronos[0].ring = &firstRing;
+}
+
+
+//##################### Splits ring buffer ##################################
+
+// Empty ring holding up to "capacity" splits in "times".
+void split_ring_init(split_ring_S *ring, uint32_t *times, int capacity)
+{
+  ring->times = times;
+  ring->capacity = capacity;
+  split_ring_clear(ring);
+}
+
+
+int split_ring_capacity(const split_ring_S *ring)
+{
+  return ring->capacity;
+}
+
+
+int split_ring_count(const split_ring_S *ring)
+{
+  return ring->count;
+}
+
+
+bool split_ring_full(const split_ring_S *ring)
+{
+  return ring->count == ring->capacity;
+}
+
+
+void split_ring_clear(split_ring_S *ring)
+{
+  ring->head = 0;
+  ring->count = 0;
+  ring->before = 0;
+  ring->dropped = 0;
+}
+
+
+// Add a split after the latest. When full, the earliest split is replaced.
+void split_ring_push(split_ring_S *ring, uint32_t splitMs)
+{
+  int slot = ring->head + ring->count;
+  if (slot >= ring->capacity)
+  {
+    slot -= ring->capacity;
+  }
+
+  // When full, the slot after the latest holds the earliest.
+  if (ring->count == ring->capacity)
+  {
+    ring->before = ring->times[slot];
+    ring->dropped++;
+  }
+
+  ring->times[slot] = splitMs;
+
+  if (ring->count < ring->capacity)
+  {
+    ring->count++;
+  }
+  else
+  {
+    ring->head = (ring->head + 1) % ring->capacity;
+  }
+}
+
+
+// Start iterating at logical "index" (0 is the earliest split).
+split_ring_iter_S split_ring_iter(const split_ring_S *ring, int index)
+{
+  split_ring_iter_S iter = {.ring = ring,
+                            .slot = (ring->head + index) % ring->capacity,
+                            .remaining = ring->count - index};
+  return iter;
+}
+
+
+// Get the next split. Returns false when past the latest split.
+bool split_ring_next(split_ring_iter_S *iter, uint32_t *splitMs)
+{
+  if (iter->remaining <= 0)
+  {
+    return false;
+  }
+
+  *splitMs = iter->ring->times[iter->slot];
+
+  iter->slot = (iter->slot + 1 == iter->ring->capacity) ? 0 : iter->slot + 1;
+  iter->remaining--;
+  return true;
+}
+
+
+//##################### Laps #################################################
+
+// Lap ending at "splitMs". A split earlier than the previous one follows a reset that kept
+// the splits, so its lap is measured from zero.
+uint32_t split_lap(uint32_t prevSplitMs, uint32_t splitMs)
+{
+  return splitMs >= prevSplitMs ? splitMs - prevSplitMs : splitMs;
+}
+
+
+void lap_stats_clear(lap_stats_S *stats)
+{
+  memset(stats, 0, sizeof(lap_stats_S));
+}
+
+
+// Add the lap ending at "splitMs". Constant time.
+void lap_stats_add(lap_stats_S *stats, uint32_t splitMs)
+{
+  uint32_t lap = split_lap(stats->latestSplit, splitMs);
+  stats->latestSplit = splitMs;
+
+  if (stats->count == 0 || lap < stats->min)
+  {
+    stats->min = lap;
+  }
+  if (stats->count == 0 || lap > stats->max)
+  {
+    stats->max = lap;
+  }
+  stats->total += lap;
+
+  // Rolling average. The slot for this lap holds the one LAP_ROLLING_CNT laps ago.
+  int slot = stats->count % LAP_ROLLING_CNT;
+  stats->recentTotal += lap - stats->recent[slot];
+  stats->recent[slot] = lap;
+
+  stats->count++;
+}
+
+
+// Mean of all laps, or zero if none.
+uint32_t lap_stats_mean(const lap_stats_S *stats)
+{
+  return stats->count > 0 ? stats->total / stats->count : 0;
+}
+
+
+// Mean of the latest LAP_ROLLING_CNT laps, or of all laps if fewer.
+uint32_t lap_stats_rolling(const lap_stats_S *stats)
+{
+  int recentCnt = stats->count < LAP_ROLLING_CNT ? stats->count : LAP_ROLLING_CNT;
+  return recentCnt > 0 ? stats->recentTotal / recentCnt : 0;
+}
+
+
+//##################### Chronometer state ###################################
+
+// Current wall clock time in milliseconds.
+int64_t chrono_now_ms()
+{
+  time_t sec;
+  uint16_t ms;
+  time_ms(&sec, &ms);
+
+  return (int64_t)sec * 1000 + ms;
+}
+
+
+// Select the chronometer the other chrono_ functions act on. Does not notify.
+void chrono_select(int index)
+{
+  if (index >= 0 && index < CHRONO_COUNT)
+  {
+    chrono = &chronos[index];
+  }
+}
+
+
+int chrono_selected()
+{
+  return chrono - chronos;
+}
+
+
+bool chrono_running()
+{
+  return chrono->runSelect == RUN_START;
+}
+
+
+bool chrono_has_been_reset()
+{
+  return chrono->hasBeenReset;
+}
+
+
+// Wall clock time (ms) the current run was first started, or zero if not started since reset.
+int64_t chrono_run_start_ms()
+{
+  return chrono->runStartMs;
+}
+
+
+// Chronometer elapsed ms as of wall clock time "nowMs".
+uint32_t chrono_elapsed_at(int64_t nowMs)
+{
+  if (chrono->runSelect == RUN_START)
+  {
+    int64_t elapsed = chrono->accumulated + (nowMs - chrono->startMs);
+    return elapsed > 0 ? (uint32_t)elapsed : 0;
+  }
+
+  return chrono->accumulated;
+}
+
+
+// Chronometer elapsed ms as of the current wall clock time.
+uint32_t chrono_elapsed()
+{
+  return chrono_elapsed_at(chrono_now_ms());
+}
+
+
+const split_ring_S *chrono_splits()
+{
+  return chrono->ring != NULL ? chrono->ring : &emptyRing;
+}
+
+
+const lap_stats_S *chrono_lap_stats()
+{
+  return &chrono->lapStats;
+}
+
+
+// Latest split, or zero if there are none.
+uint32_t chrono_latest_split()
+{
+  const split_ring_S *ring = chrono_splits();
+  uint32_t splitMs = 0;
+  if (ring->count > 0)
+  {
+    split_ring_iter_S iter = split_ring_iter(ring, ring->count - 1);
+    split_ring_next(&iter, &splitMs);
+  }
+
+  return splitMs;
+}
+
+
+//##################### Chronometer events ##################################
+
+// Splits of the selected chronometer, allocating them if it has none. The ring and its
+// OTHER_MAX_SPLITS times are one allocation. NULL if out of memory.
+static split_ring_S *chrono_ring()
+{
+  if (chrono->ring == NULL)
+  {
+    chrono->ring = malloc(sizeof(split_ring_S) + OTHER_MAX_SPLITS * sizeof(uint32_t));
+    if (chrono->ring == NULL)
+    {
+      APP_LOG(APP_LOG_LEVEL_DEBUG, "no memory for chronometer %i splits", chrono_selected() + 1);
+      return NULL;
+    }
+    split_ring_init(chrono->ring, (uint32_t *)(chrono->ring + 1), OTHER_MAX_SPLITS);
+  }
+
+  return chrono->ring;
+}
+
+
+// Splits and their lap statistics always change together. Returns false if there is no
+// memory for the chronometer's splits.
+static bool chrono_push_split(uint32_t splitMs)
+{
+  if (chrono_ring() == NULL)
+  {
+    return false;
+  }
+
+  split_ring_push(chrono->ring, splitMs);
+  lap_stats_add(&chrono->lapStats, splitMs);
+  return true;
+}
+
+
+static void chrono_drop_splits()
+{
+  if (chrono->ring == &firstRing)
+  {
+    split_ring_clear(chrono->ring);
+  }
+  else
+  {
+    free(chrono->ring);
+    chrono->ring = NULL;
+  }
+
+  lap_stats_clear(&chrono->lapStats);
+}
+
+
+void chrono_set_change_handler(ChronoChangeHandler handler)
+{
+  changeHandler = handler;
+}
+
+
+static void chrono_notify(ChronoChanges changes)
+{
+  if (changeHandler != NULL)
+  {
+    changeHandler(changes);
+  }
+}
+
+
+// Set chronometer to have had "elapsed" ms as of wall clock time "asOfMs" with run state "runSelect".
+// Used both to (re)start the chronometer and to catch up with time that passed while the app was closed.
+static void chrono_set(short runSelect, uint32_t elapsed, int64_t asOfMs)
+{
+  chrono->runSelect = runSelect;
+  chrono->accumulated = elapsed;
+  chrono->startMs = asOfMs;
+}
+
+
+// Start or stop the chronometer as of wall clock time "nowMs", capturing elapsed time at the
+// transition. A stopped chronometer needs a reset before it reads zero again.
+static void chrono_toggle_run_at(int64_t nowMs)
+{
+  chrono_set((chrono->runSelect + 1) % RUN_MAX, chrono_elapsed_at(nowMs), nowMs);
+
+  if (chrono->runSelect == RUN_STOP)
+  {
+    chrono->hasBeenReset = false;
+  }
+  else if (chrono->runStartMs == 0)
+  {
+    chrono->runStartMs = nowMs;
+  }
+
+  chrono_notify(CHRONO_CHANGED_RUN);
+}
+
+
+// Add a split at the elapsed time as of wall clock time "pressMs", when the split button was
+// pressed. Only while running, and when full only if "replaceOldest". A press before the latest
+// start counts as at the start. Returns false if no split was taken.
+bool chrono_split_at(int64_t pressMs, bool replaceOldest)
+{
+  if (chrono->runSelect != RUN_START || (split_ring_full(chrono_splits()) && ! replaceOldest) ||
+      ! chrono_push_split(chrono_elapsed_at(pressMs > chrono->startMs ? pressMs : chrono->startMs)))
+  {
+    return false;
+  }
+
+  chrono_notify(CHRONO_CHANGED_SPLIT_ADDED);
+  return true;
+}
+
+
+// Clear the chronometer back to zero, and the splits too if "clearSplits". Run state is unchanged.
+void chrono_reset(bool clearSplits)
+{
+  chrono->accumulated = 0;
+  chrono->startMs = chrono_now_ms();
+  chrono->hasBeenReset = true;
+
+  // A reset while running begins a new run.
+  chrono->runStartMs = (chrono->runSelect == RUN_START) ? chrono->startMs : 0;
+
+  if (clearSplits)
+  {
+    chrono_drop_splits();
+  }
+
+  chrono_notify(clearSplits ? CHRONO_CHANGED_RESET | CHRONO_CHANGED_SPLITS_CLEARED : CHRONO_CHANGED_RESET);
+}
+
+
+void chrono_clear_splits()
+{
+  chrono_drop_splits();
+
+  chrono_notify(CHRONO_CHANGED_SPLITS_CLEARED);
+}
+
+
+//##################### Input events #########################################
+
+// Queue a press at wall clock time "atMs" for the selected chronometer. Returns false if the
+// queue is full; drain it and push again.
+bool chrono_input_push(ChronoInputType type, int64_t atMs)
+{
+  uint8_t next = (inputHead + 1) % CHRONO_INPUT_MAX;
+  if (next == inputTail)
+  {
+    return false;
+  }
+
+  inputs[inputHead] = (chrono_input_S){.type = type, .atMs = atMs};
+  inputHead = next;
+  return true;
+}
+
+
+bool chrono_input_pending()
+{
+  return inputHead != inputTail;
+}
+
+
+// Apply queued presses in order, each as of its own time. Each notifies the change handler.
+void chrono_input_drain(bool replaceOldest)
+{
+  while (inputTail != inputHead)
+  {
+    chrono_input_S input = inputs[inputTail];
+    inputTail = (inputTail + 1) % CHRONO_INPUT_MAX;
+
+    if (input.type == CHRONO_INPUT_SPLIT)
+    {
+      chrono_split_at(input.atMs, replaceOldest);
+    }
+    else
+    {
+      chrono_toggle_run_at(input.atMs);
+    }
+  }
+}
+
+
+//##################### Restore ##############################################
+
+// Chronometer had "elapsed" ms as of wall clock time "asOfMs". If running, time that passed
+// while the app was not running is picked up the same way as after any start.
+void chrono_restore(short runSelect, uint32_t elapsed, int64_t asOfMs, bool hasBeenReset)
+{
+  chrono_set(runSelect == RUN_START ? RUN_START : RUN_STOP, elapsed, asOfMs);
+  chrono->hasBeenReset = hasBeenReset;
+}
+
+
+void chrono_restore_run_start(int64_t runStartMs)
+{
+  chrono->runStartMs = runStartMs;
+}
+
+
+// Add a saved split after the latest. Lap statistics are rebuilt from the saved splits, then
+// completed by chrono_restore_lap_stats().
+void chrono_restore_split(uint32_t splitMs)
+{
+  chrono_push_split(splitMs);
+}
+
+
+// Only the latest splits were saved. "beforeMs" is the split before the earliest saved one,
+// which its lap is measured from. Call before restoring the splits.
+void chrono_restore_splits_before(uint32_t beforeMs)
+{
+  if (beforeMs != 0 && chrono_ring() != NULL)
+  {
+    chrono->ring->before = beforeMs;
+    chrono->lapStats.latestSplit = beforeMs;
+  }
+}
+
+
+// Number of splits replaced when full before the earliest saved one. Call before restoring the splits.
+void chrono_restore_splits_dropped(uint32_t droppedCnt)
+{
+  if (droppedCnt != 0 && chrono_ring() != NULL)
+  {
+    chrono->ring->dropped = droppedCnt;
+  }
+}
+
+
+// Lap count, fastest, slowest and total as saved, which also cover the laps of splits replaced
+// when full. Call after restoring the splits, which rebuild the latest laps. Ignored if the
+// splits hold as many laps, as they then rebuild the same statistics.
+void chrono_restore_lap_stats(const lap_stats_S *saved)
+{
+  lap_stats_S *stats = &chrono->lapStats;
+  if (saved->count <= stats->count || stats->count < LAP_ROLLING_CNT)
+  {
+    return;
+  }
+
+  // Move the latest laps to the slots the next laps replace in turn.
+  uint32_t recent[LAP_ROLLING_CNT];
+  for (int i = 0; i < LAP_ROLLING_CNT; i++)
+  {
+    recent[(saved->count + i) % LAP_ROLLING_CNT] = stats->recent[(stats->count + i) % LAP_ROLLING_CNT];
+  }
+  memcpy(stats->recent, recent, sizeof(recent));
+
+  stats->count = saved->count;
+  stats->min = saved->min;
+  stats->max = saved->max;
+  stats->total = saved->total;
+}
+
+
+// Drop all splits before restoring them, or when saved splits turn out to be damaged.
+void chrono_restore_no_splits()
+{
+  chrono_drop_splits();
+}
@@ -0,0 +1,133 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// Chronometer and splits model. Holds no UI state and does no formatting or layer calls.
+// The UI is told of each change through the handler set by chrono_set_change_handler().
+
+#pragma once
+
+#include "pebble.h"
+
+// Start/Stop select
+#define RUN_START 0
+#define RUN_STOP 1
+#define RUN_MAX 2
+
+// Independent chronometers. Each has its own run state and splits; one is selected at a time
+// and all state, event and restore functions act on the selected one.
+#ifdef PBL_COLOR
+#define CHRONO_COUNT 4
+#else
+#define CHRONO_COUNT 2
+#endif
+
+// Splits. Kept in a ring buffer so a split costs the same however full it is.
+// Logical index 0 is the earliest split. All chronometer and split times are in milliseconds.
+// RAM: the first chronometer's ring is static, 4 bytes a split (2000 bytes). The others are
+// allocated on their first split, 4 bytes a split plus 24 bytes (152 bytes each).
+#define MAX_SPLITS 500      // First chronometer.
+#define OTHER_MAX_SPLITS 32 // Each other chronometer.
+typedef struct split_ring_S
+{
+  uint32_t *times; // Room for "capacity" splits.
+  int capacity;
+  int head;        // Storage slot of the earliest split.
+  int count;       // Number of splits held.
+  uint32_t before;  // Latest split replaced when full, so the earliest lap can be measured. Zero if none.
+  uint32_t dropped; // Splits replaced when full, so splits keep their numbers.
+} split_ring_S;
+
+// Walks a split ring from a logical index towards the latest split.
+typedef struct split_ring_iter_S
+{
+  const split_ring_S *ring;
+  int slot;
+  int remaining;
+} split_ring_iter_S;
+
+// Lap statistics, updated as each split is added rather than by rescanning the splits.
+// A lap is the time from the previous split, or from zero for the first. They cover every
+// split since the splits were cleared, including any replaced when full, so their count,
+// fastest, slowest and total are saved with the splits (see chrono_restore_lap_stats()).
+#define LAP_ROLLING_CNT 5
+typedef struct lap_stats_S
+{
+  int count;                         // Laps recorded.
+  uint32_t latestSplit;              // Split the next lap is measured from.
+  uint32_t min;                      // Fastest lap.
+  uint32_t max;                      // Slowest lap.
+  uint32_t total;                    // Sum of all laps.
+  uint32_t recent[LAP_ROLLING_CNT];  // Latest laps, oldest replaced first.
+  uint32_t recentTotal;              // Sum of recent[].
+} lap_stats_S;
+
+// Model changes passed to the change handler.
+typedef enum
+{
+  CHRONO_CHANGED_RUN = 1 << 0,            // Started or stopped.
+  CHRONO_CHANGED_RESET = 1 << 1,          // Cleared back to zero.
+  CHRONO_CHANGED_SPLIT_ADDED = 1 << 2,    // Split added after the latest.
+  CHRONO_CHANGED_SPLITS_CLEARED = 1 << 3, // All splits removed.
+} ChronoChanges;
+
+typedef void (*ChronoChangeHandler)(ChronoChanges changes);
+
+// Presses queued by the button handlers and applied by chrono_input_drain(), so each press of a
+// burst is its own event with its own time. One slot is kept free to tell full from empty.
+#define CHRONO_INPUT_MAX 16
+typedef enum
+{
+  CHRONO_INPUT_SPLIT,      // Split, as by chrono_split_at().
+  CHRONO_INPUT_TOGGLE_RUN, // Start or stop.
+} ChronoInputType;
+
+// Split ring buffer.
+void split_ring_init(split_ring_S *ring, uint32_t *times, int capacity);
+int split_ring_capacity(const split_ring_S *ring);
+int split_ring_count(const split_ring_S *ring);
+bool split_ring_full(const split_ring_S *ring);
+void split_ring_clear(split_ring_S *ring);
+void split_ring_push(split_ring_S *ring, uint32_t splitMs);
+split_ring_iter_S split_ring_iter(const split_ring_S *ring, int index);
+bool split_ring_next(split_ring_iter_S *iter, uint32_t *splitMs);
+
+// Laps.
+uint32_t split_lap(uint32_t prevSplitMs, uint32_t splitMs);
+void lap_stats_clear(lap_stats_S *stats);
+void lap_stats_add(lap_stats_S *stats, uint32_t splitMs);
+uint32_t lap_stats_mean(const lap_stats_S *stats);
+uint32_t lap_stats_rolling(const lap_stats_S *stats);
+
+// Chronometers.
+void chrono_init();
+void chrono_select(int index);
+int chrono_selected();
+
+// State.
+int64_t chrono_now_ms();
+bool chrono_running();
+bool chrono_has_been_reset();
+int64_t chrono_run_start_ms();
+uint32_t chrono_elapsed_at(int64_t nowMs);
+uint32_t chrono_elapsed();
+const split_ring_S *chrono_splits();
+const lap_stats_S *chrono_lap_stats();
+uint32_t chrono_latest_split();
+
+// Events. Each notifies the change handler.
+void chrono_set_change_handler(ChronoChangeHandler handler);
+bool chrono_split_at(int64_t pressMs, bool replaceOldest);
+void chrono_reset(bool clearSplits);
+void chrono_clear_splits();
+
+// Input events.
+bool chrono_input_push(ChronoInputType type, int64_t atMs);
+bool chrono_input_pending();
+void chrono_input_drain(bool replaceOldest);
+
+// Restore of saved state. These do not notify.
+void chrono_restore(short runSelect, uint32_t elapsed, int64_t asOfMs, bool hasBeenReset);
+void chrono_restore_run_start(int64_t runStartMs);
+void chrono_restore_split(uint32_t splitMs);
+void chrono_restore_splits_before(uint32_t beforeMs);
+void chrono_restore_splits_dropped(uint32_t droppedCnt);
+void chrono_restore_lap_stats(const lap_stats_S *saved);
+void chrono_restore_no_splits();
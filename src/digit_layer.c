@@ -0,0 +1,420 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// Time digits drawn from an atlas of glyph bitmaps. See digit_layer.h.
+
+#include "pebble.h"
+#include "digit_layer.h"
+
+// Glyphs are side by side in one bitmap, 1 bit per pixel, set where the font drew.
+// Color platforms use a 2 color palette so colors change without redrawing the glyphs.
+struct digit_atlas_S
+{
+  GFont font;         // Until the glyphs are captured.
+  const char *glyphs;
+  int glyphCnt;
+  uint16_t x[DIGIT_ATLAS_MAX_GLYPHS + 1]; // Left edge of each glyph in the bitmap, then its width.
+  int16_t height;
+  GBitmap *bitmap;
+  bool captured;
+};
+
+typedef struct digit_layer_S
+{
+  digit_atlas_S *atlas; // NULL to draw with fallbackFont.
+  GFont fallbackFont;
+  const char *text;
+  GTextAlignment alignment;
+  GColor foreground;
+  GColor background;
+  Layer *cells[DIGIT_LAYER_MAX_CELLS]; // Child layers, one per character. Only with an atlas.
+} digit_layer_S;
+
+// Cell drawing one character of its digit layer.
+typedef struct digit_cell_S
+{
+  digit_layer_S *digits;
+  char c; // '\0' while unused.
+} digit_cell_S;
+
+
+//##################### Atlas ###############################################
+
+digit_atlas_S *digit_atlas_create(ResHandle fontHandle, const char *glyphs, int16_t height)
+{
+  digit_atlas_S *atlas = malloc(sizeof(digit_atlas_S));
+  if (atlas == NULL)
+  {
+    return NULL;
+  }
+
+  memset(atlas, 0, sizeof(digit_atlas_S));
+  atlas->font = fonts_load_custom_font(fontHandle);
+  atlas->glyphs = glyphs;
+  atlas->height = height;
+
+  // Each glyph's cell is as wide as the font draws it.
+  char glyph[2] = {'\0', '\0'};
+  for (atlas->glyphCnt = 0; glyphs[atlas->glyphCnt] != '\0' && atlas->glyphCnt < DIGIT_ATLAS_MAX_GLYPHS;
+       atlas->glyphCnt++)
+  {
+    glyph[0] = glyphs[atlas->glyphCnt];
+    GSize size = graphics_text_layout_get_content_size(glyph, atlas->font, GRect(0, 0, 144, height),
+                                                       GTextOverflowModeFill, GTextAlignmentLeft);
+    atlas->x[atlas->glyphCnt + 1] = atlas->x[atlas->glyphCnt] + size.w;
+  }
+
+  GSize size = GSize(atlas->x[atlas->glyphCnt], height);
+  #ifdef PBL_COLOR
+  GColor *palette = malloc(2 * sizeof(GColor));
+  if (palette != NULL)
+  {
+    palette[0] = GColorWhite;
+    palette[1] = GColorBlack;
+    atlas->bitmap = gbitmap_create_blank_with_palette(size, GBitmapFormat1BitPalette, palette, true);
+    if (atlas->bitmap == NULL)
+    {
+      free(palette);
+    }
+  }
+  #else
+  atlas->bitmap = gbitmap_create_blank(size, GBitmapFormat1Bit);
+  #endif
+
+  if (atlas->bitmap == NULL)
+  {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "no memory for digit atlas");
+    digit_atlas_destroy(atlas);
+    return NULL;
+  }
+
+  memset(gbitmap_get_data(atlas->bitmap), 0, gbitmap_get_bytes_per_row(atlas->bitmap) * height);
+  return atlas;
+}
+
+
+void digit_atlas_destroy(digit_atlas_S *atlas)
+{
+  if (atlas == NULL)
+  {
+    return;
+  }
+
+  if (atlas->font != NULL)
+  {
+    fonts_unload_custom_font(atlas->font);
+  }
+  if (atlas->bitmap != NULL)
+  {
+    gbitmap_destroy(atlas->bitmap);
+  }
+  free(atlas);
+}
+
+
+// Index of "c" in the atlas, or -1.
+static int digit_atlas_find(const digit_atlas_S *atlas, char c)
+{
+  for (int i = 0; i < atlas->glyphCnt; i++)
+  {
+    if (atlas->glyphs[i] == c)
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+
+static int digit_atlas_glyph_width(const digit_atlas_S *atlas, int glyph)
+{
+  return atlas->x[glyph + 1] - atlas->x[glyph];
+}
+
+
+// Frame buffer pixel at screen "x", "y" differs from black.
+static bool digit_frame_buffer_lit(GBitmap *frameBuffer, int x, int y)
+{
+  uint8_t *row = gbitmap_get_data(frameBuffer) + y * gbitmap_get_bytes_per_row(frameBuffer);
+
+  // Black and white frame buffer: least significant bit is leftmost, set bits are white.
+  if (gbitmap_get_format(frameBuffer) == GBitmapFormat1Bit)
+  {
+    return (row[x / 8] >> (x % 8)) & 1;
+  }
+
+  return ! gcolor_equal((GColor8){.argb = row[x]}, GColorBlack);
+}
+
+
+static void digit_atlas_set_pixel(digit_atlas_S *atlas, int x, int y)
+{
+  uint8_t *row = gbitmap_get_data(atlas->bitmap) + y * gbitmap_get_bytes_per_row(atlas->bitmap);
+
+  #ifdef PBL_COLOR
+  // Palettized: most significant bit is leftmost.
+  row[x / 8] |= 0x80 >> (x % 8);
+  #else
+  row[x / 8] |= 1 << (x % 8);
+  #endif
+}
+
+
+// Draw each glyph white on black in the layer, at "origin" on screen, and copy it from the
+// frame buffer into the atlas. The font is then no longer needed. Should the frame buffer
+// be unavailable, capture is tried again on the next draw.
+static void digit_atlas_capture(digit_atlas_S *atlas, GContext *ctx, GRect bounds, GPoint origin)
+{
+  char glyph[2] = {'\0', '\0'};
+  for (int i = 0; i < atlas->glyphCnt; i++)
+  {
+    glyph[0] = atlas->glyphs[i];
+    graphics_context_set_fill_color(ctx, GColorBlack);
+    graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+    graphics_context_set_text_color(ctx, GColorWhite);
+    graphics_draw_text(ctx, glyph, atlas->font, bounds, GTextOverflowModeFill, GTextAlignmentLeft, NULL);
+
+    GBitmap *frameBuffer = graphics_capture_frame_buffer(ctx);
+    if (frameBuffer == NULL)
+    {
+      return;
+    }
+
+    int width = digit_atlas_glyph_width(atlas, i);
+    for (int y = 0; y < atlas->height && y < bounds.size.h; y++)
+    {
+      for (int x = 0; x < width && x < bounds.size.w; x++)
+      {
+        if (digit_frame_buffer_lit(frameBuffer, origin.x + x, origin.y + y))
+        {
+          digit_atlas_set_pixel(atlas, atlas->x[i] + x, y);
+        }
+      }
+    }
+
+    graphics_release_frame_buffer(ctx, frameBuffer);
+  }
+
+  fonts_unload_custom_font(atlas->font);
+  atlas->font = NULL;
+  atlas->captured = true;
+}
+
+
+//##################### Layer ###############################################
+
+// Cells are drawn after their layer, which clears the space around them and captures the atlas.
+static void digit_layer_update_proc(Layer *layer, GContext *ctx)
+{
+  digit_layer_S *digits = layer_get_data(layer);
+  digit_atlas_S *atlas = digits->atlas;
+  GRect bounds = layer_get_bounds(layer);
+
+  if (atlas != NULL && ! atlas->captured)
+  {
+    digit_atlas_capture(atlas, ctx, bounds, layer_get_frame(layer).origin);
+  }
+
+  graphics_context_set_fill_color(ctx, digits->background);
+  graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+
+  if (atlas == NULL && digits->text != NULL)
+  {
+    graphics_context_set_text_color(ctx, digits->foreground);
+    graphics_draw_text(ctx, digits->text, digits->fallbackFont, bounds, GTextOverflowModeFill,
+                       digits->alignment, NULL);
+  }
+}
+
+
+static void digit_cell_update_proc(Layer *layer, GContext *ctx)
+{
+  digit_cell_S *cell = layer_get_data(layer);
+  digit_layer_S *digits = cell->digits;
+  digit_atlas_S *atlas = digits->atlas;
+  GRect bounds = layer_get_bounds(layer);
+
+  graphics_context_set_fill_color(ctx, digits->background);
+  graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+
+  int glyph = digit_atlas_find(atlas, cell->c);
+  if ( ! atlas->captured || glyph < 0)
+  {
+    return;
+  }
+
+  // The atlas is shared by layers that may differ in color.
+  #ifdef PBL_COLOR
+  GColor *palette = gbitmap_get_palette(atlas->bitmap);
+  palette[0] = digits->background;
+  palette[1] = digits->foreground;
+  #else
+  // Set bits are drawn white.
+  graphics_context_set_compositing_mode(ctx, gcolor_equal(digits->foreground, GColorWhite) ? GCompOpAssign
+                                                                                           : GCompOpAssignInverted);
+  #endif
+
+  gbitmap_set_bounds(atlas->bitmap, GRect(atlas->x[glyph], 0, bounds.size.w, atlas->height));
+  graphics_draw_bitmap_in_rect(ctx, atlas->bitmap, bounds);
+}
+
+
+Layer *digit_layer_create(GRect frame, digit_atlas_S *atlas, GFont fallbackFont, GTextAlignment alignment)
+{
+  Layer *layer = layer_create_with_data(frame, sizeof(digit_layer_S));
+  if (layer == NULL)
+  {
+    return NULL;
+  }
+
+  digit_layer_S *digits = layer_get_data(layer);
+  *digits = (digit_layer_S){.atlas = atlas, .fallbackFont = fallbackFont, .text = NULL,
+                            .alignment = alignment, .foreground = GColorBlack, .background = GColorWhite};
+  layer_set_update_proc(layer, digit_layer_update_proc);
+
+  // Cells start hidden and empty. Without memory for one, the atlas is not used.
+  for (int i = 0; i < DIGIT_LAYER_MAX_CELLS && digits->atlas != NULL; i++)
+  {
+    digits->cells[i] = layer_create_with_data(GRect(0, 0, 0, frame.size.h), sizeof(digit_cell_S));
+    if (digits->cells[i] == NULL)
+    {
+      APP_LOG(APP_LOG_LEVEL_DEBUG, "no memory for digit cells");
+      digits->atlas = NULL;
+      break;
+    }
+
+    digit_cell_S *cell = layer_get_data(digits->cells[i]);
+    cell->digits = digits;
+    cell->c = '\0';
+    layer_set_hidden(digits->cells[i], true);
+    layer_set_update_proc(digits->cells[i], digit_cell_update_proc);
+    layer_add_child(layer, digits->cells[i]);
+  }
+
+  return layer;
+}
+
+
+void digit_layer_destroy(Layer *layer)
+{
+  digit_layer_S *digits = layer_get_data(layer);
+  for (int i = 0; i < DIGIT_LAYER_MAX_CELLS; i++)
+  {
+    if (digits->cells[i] != NULL)
+    {
+      layer_destroy(digits->cells[i]);
+    }
+  }
+
+  layer_destroy(layer);
+}
+
+
+// Lay out "text" in cells. Only cells whose character or position changed are marked dirty,
+// and the layer itself only when the text's extent changed.
+static void digit_layer_set_cells(Layer *layer, digit_layer_S *digits)
+{
+  digit_atlas_S *atlas = digits->atlas;
+  const char *text = (digits->text != NULL) ? digits->text : "";
+  GRect bounds = layer_get_bounds(layer);
+
+  int width = 0;
+  for (const char *c = text; *c != '\0'; c++)
+  {
+    int glyph = digit_atlas_find(atlas, *c);
+    width += digit_atlas_glyph_width(atlas, glyph >= 0 ? glyph : 0);
+  }
+
+  int x = 0;
+  if (digits->alignment == GTextAlignmentRight)
+  {
+    x = bounds.size.w - width;
+  }
+  else if (digits->alignment == GTextAlignmentCenter)
+  {
+    x = (bounds.size.w - width) / 2;
+  }
+
+  bool extentChanged = false;
+  for (int i = 0; i < DIGIT_LAYER_MAX_CELLS; i++)
+  {
+    Layer *cellLayer = digits->cells[i];
+    digit_cell_S *cell = layer_get_data(cellLayer);
+    char c = *text;
+
+    if (c == '\0')
+    {
+      if ( ! layer_get_hidden(cellLayer))
+      {
+        cell->c = '\0';
+        layer_set_hidden(cellLayer, true);
+        extentChanged = true;
+      }
+      continue;
+    }
+    text++;
+
+    int glyph = digit_atlas_find(atlas, c);
+    GRect frame = GRect(x, 0, digit_atlas_glyph_width(atlas, glyph >= 0 ? glyph : 0), atlas->height);
+    x += frame.size.w;
+
+    GRect shownFrame = layer_get_frame(cellLayer);
+    bool moved = shownFrame.origin.x != frame.origin.x || shownFrame.size.w != frame.size.w ||
+                 shownFrame.size.h != frame.size.h;
+    if (moved || layer_get_hidden(cellLayer))
+    {
+      layer_set_frame(cellLayer, frame);
+      layer_set_hidden(cellLayer, false);
+      extentChanged = true;
+    }
+    if (moved || cell->c != c)
+    {
+      cell->c = c;
+      layer_mark_dirty(cellLayer);
+    }
+  }
+
+  if (extentChanged)
+  {
+    layer_mark_dirty(layer);
+  }
+}
+
+
+void digit_layer_set_text(Layer *layer, const char *text)
+{
+  digit_layer_S *digits = layer_get_data(layer);
+  digits->text = text;
+
+  if (digits->atlas != NULL)
+  {
+    digit_layer_set_cells(layer, digits);
+  }
+  else
+  {
+    layer_mark_dirty(layer);
+  }
+}
+
+
+const char *digit_layer_get_text(Layer *layer)
+{
+  return ((digit_layer_S *)layer_get_data(layer))->text;
+}
+
+
+// Layers sharing an atlas may differ in color.
+void digit_layer_set_colors(Layer *layer, GColor foreground, GColor background)
+{
+  digit_layer_S *digits = layer_get_data(layer);
+  digits->foreground = foreground;
+  digits->background = background;
+
+  layer_mark_dirty(layer);
+  for (int i = 0; i < DIGIT_LAYER_MAX_CELLS; i++)
+  {
+    if (digits->cells[i] != NULL)
+    {
+      layer_mark_dirty(digits->cells[i]);
+    }
+  }
+}
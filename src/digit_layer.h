@@ -0,0 +1,31 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// Time digits drawn from an atlas of glyph bitmaps rather than a font. On the first draw, each
+// glyph is drawn once with the font and captured from the frame buffer into a 1 bit atlas, then
+// the font is unloaded. Later draws only blit glyphs. Each character is a cell of its own, and
+// setting the text only marks the cells whose glyph or position changed.
+
+#pragma once
+
+#include "pebble.h"
+
+#define DIGIT_ATLAS_MAX_GLYPHS 16
+#define DIGIT_LAYER_MAX_CELLS 8 // Longest text a layer shows.
+
+typedef struct digit_atlas_S digit_atlas_S;
+
+// Atlas of "glyphs" in the font resource "fontHandle", for layers "height" pixels high.
+// Characters not in "glyphs" are drawn blank, as wide as the first glyph. NULL if out of memory.
+digit_atlas_S *digit_atlas_create(ResHandle fontHandle, const char *glyphs, int16_t height);
+void digit_atlas_destroy(digit_atlas_S *atlas);
+
+// Layer drawing text from "atlas". Its frame must be in screen coordinates, i.e. it must be a
+// child of a fullscreen window's root layer, so glyphs can be found in the frame buffer.
+// Without an atlas, the text is drawn with "fallbackFont" instead. Destroy with digit_layer_destroy().
+Layer *digit_layer_create(GRect frame, digit_atlas_S *atlas, GFont fallbackFont, GTextAlignment alignment);
+void digit_layer_destroy(Layer *layer);
+
+// As text_layer_set_text(), "text" is not copied and must outlive its display.
+void digit_layer_set_text(Layer *layer, const char *text);
+const char *digit_layer_get_text(Layer *layer);
+
+void digit_layer_set_colors(Layer *layer, GColor foreground, GColor background);
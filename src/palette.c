@@ -0,0 +1,210 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// Color Select palette. See palette.h.
+
+#include "pebble.h"
+#include "palette.h"
+
+#ifdef PBL_COLOR
+
+typedef struct palette_color_S
+{
+  const char *name;
+  GColor8 color;
+} palette_color_S;
+
+typedef struct palette_group_S
+{
+  const char *name;
+  uint8_t first; // Palette index of the group's first color.
+} palette_group_S;
+
+#define PALETTE_COLOR(id, name) {name, {.argb = GColor##id##ARGB8}}
+
+static const palette_color_S PALETTE[] =
+  {// Grays 0
+   PALETTE_COLOR(Black, "Black"),
+   PALETTE_COLOR(DarkGray, "Dark Gray"),
+   PALETTE_COLOR(LightGray, "Light Gray"),
+   // Reds 3
+   PALETTE_COLOR(BulgarianRose, "Bulgarian Rose"),
+   PALETTE_COLOR(DarkCandyAppleRed, "Dark Candy Apple Red"),
+   PALETTE_COLOR(RoseVale, "Rose Vale"),
+   PALETTE_COLOR(Red, "Red"),
+   PALETTE_COLOR(Folly, "Folly"),
+   PALETTE_COLOR(SunsetOrange, "Sunset Orange"),
+   PALETTE_COLOR(Melon, "Melon"),
+   // Oranges 10
+   PALETTE_COLOR(WindsorTan, "Windsor Tan"),
+   PALETTE_COLOR(Brass, "Brass"),
+   PALETTE_COLOR(Orange, "Orange"),
+   PALETTE_COLOR(ChromeYellow, "Chrome Yellow"),
+   PALETTE_COLOR(Rajah, "Rajah"),
+   // Yellows 15
+   PALETTE_COLOR(ArmyGreen, "Army Green"),
+   PALETTE_COLOR(Limerick, "Limerick"),
+   PALETTE_COLOR(Yellow, "Yellow"),
+   PALETTE_COLOR(Icterine, "Icterine"),
+   PALETTE_COLOR(PastelYellow, "Pastel Yellow"),
+   // Greens 20
+   PALETTE_COLOR(DarkGreen, "Dark Green"),
+   PALETTE_COLOR(IslamicGreen, "Islamic Green"),
+   PALETTE_COLOR(JaegerGreen, "Jaeger Green"),
+   PALETTE_COLOR(KellyGreen, "Kelly Green"),
+   PALETTE_COLOR(MayGreen, "May Green"),
+   PALETTE_COLOR(Green, "Green"),
+   PALETTE_COLOR(Malachite, "Malachite"),
+   PALETTE_COLOR(MediumSpringGreen, "Medium Spring Green"),
+   PALETTE_COLOR(BrightGreen, "Bright Green"),
+   PALETTE_COLOR(ScreaminGreen, "Screamin' Green"),
+   PALETTE_COLOR(SpringBud, "Spring Bud"),
+   PALETTE_COLOR(Inchworm, "Inchworm"),
+   PALETTE_COLOR(MintGreen, "Mint Green"),
+   // Cyans 33
+   PALETTE_COLOR(MidnightGreen, "Midnight Green"),
+   PALETTE_COLOR(TiffanyBlue, "Tiffany Blue"),
+   PALETTE_COLOR(CadetBlue, "Cadet Blue"),
+   PALETTE_COLOR(Cyan, "Cyan"),
+   PALETTE_COLOR(MediumAquamarine, "Medium Aquamarine"),
+   PALETTE_COLOR(ElectricBlue, "Electric Blue"),
+   PALETTE_COLOR(Celeste, "Celeste"),
+   // Blues 40
+   PALETTE_COLOR(OxfordBlue, "Oxford Blue"),
+   PALETTE_COLOR(DukeBlue, "Duke Blue"),
+   PALETTE_COLOR(Blue, "Blue"),
+   PALETTE_COLOR(ElectricUltramarine, "Electric Ultramarine"),
+   PALETTE_COLOR(CobaltBlue, "Cobalt Blue"),
+   PALETTE_COLOR(Liberty, "Liberty"),
+   PALETTE_COLOR(BlueMoon, "Blue Moon"),
+   PALETTE_COLOR(VeryLightBlue, "Very Light Blue"),
+   PALETTE_COLOR(VividCerulean, "Vivid Cerulean"),
+   PALETTE_COLOR(PictonBlue, "Picton Blue"),
+   PALETTE_COLOR(BabyBlueEyes, "Baby Blue Eyes"),
+   // Purples 51
+   PALETTE_COLOR(ImperialPurple, "Imperial Purple"),
+   PALETTE_COLOR(Indigo, "Indigo"),
+   PALETTE_COLOR(Purple, "Purple"),
+   PALETTE_COLOR(Purpureus, "Purpureus"),
+   PALETTE_COLOR(VividViolet, "Vivid Violet"),
+   PALETTE_COLOR(LavenderIndigo, "Lavender Indigo"),
+   PALETTE_COLOR(RichBrilliantLavender, "Rich Brilliant Lavender"),
+   // Pinks 58
+   PALETTE_COLOR(JazzberryJam, "Jazzberry Jam"),
+   PALETTE_COLOR(FashionMagenta, "Fashion Magenta"),
+   PALETTE_COLOR(Magenta, "Magenta"),
+   PALETTE_COLOR(BrilliantRose, "Brilliant Rose"),
+   PALETTE_COLOR(ShockingPink, "Shocking Pink")};
+
+#define PALETTE_COUNT ((int)(sizeof(PALETTE) / sizeof(PALETTE[0])))
+
+static const palette_group_S PALETTE_GROUPS[] =
+  {{"Grays", 0},
+   {"Reds", 3},
+   {"Oranges", 10},
+   {"Yellows", 15},
+   {"Greens", 20},
+   {"Cyans", 33},
+   {"Blues", 40},
+   {"Purples", 51},
+   {"Pinks", 58}};
+
+#define PALETTE_GROUP_COUNT ((int)(sizeof(PALETTE_GROUPS) / sizeof(PALETTE_GROUPS[0])))
+
+// Colors of the original 16 entry Color Select list, by its index. Saved selections
+// are mapped through this.
+static const uint8_t PALETTE_LEGACY_ARGB8[] =
+  {GColorBlackARGB8,
+   GColorRedARGB8,
+   GColorMelonARGB8,
+   GColorDarkCandyAppleRedARGB8,
+   GColorOrangeARGB8,
+   GColorChromeYellowARGB8,
+   GColorWindsorTanARGB8,
+   GColorBlueARGB8,
+   GColorBabyBlueEyesARGB8,
+   GColorDukeBlueARGB8,
+   GColorGreenARGB8,
+   GColorMintGreenARGB8,
+   GColorIslamicGreenARGB8,
+   GColorPurpleARGB8,
+   GColorMagentaARGB8,
+   GColorImperialPurpleARGB8};
+
+
+int palette_count()
+{
+  return PALETTE_COUNT;
+}
+
+
+GColor palette_color(int index)
+{
+  return PALETTE[index].color;
+}
+
+
+const char *palette_name(int index)
+{
+  return PALETTE[index].name;
+}
+
+
+// Group holding palette "index".
+static int palette_group_of(int index)
+{
+  int group = PALETTE_GROUP_COUNT - 1;
+  while (group > 0 && PALETTE_GROUPS[group].first > index)
+  {
+    group--;
+  }
+
+  return group;
+}
+
+
+const char *palette_group_name(int index)
+{
+  return PALETTE_GROUPS[palette_group_of(index)].name;
+}
+
+
+int palette_group_first(int index, int step)
+{
+  int group = palette_group_of(index) + step;
+  if (group < 0)
+  {
+    group = 0;
+  }
+  else if (group >= PALETTE_GROUP_COUNT)
+  {
+    group = PALETTE_GROUP_COUNT - 1;
+  }
+
+  return PALETTE_GROUPS[group].first;
+}
+
+
+int palette_find(GColor color)
+{
+  for (int i = 0; i < PALETTE_COUNT; i++)
+  {
+    if (gcolor_equal(PALETTE[i].color, color))
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+
+int palette_from_legacy(int legacyIndex)
+{
+  if (legacyIndex < 0 || legacyIndex >= (int)sizeof(PALETTE_LEGACY_ARGB8))
+  {
+    return -1;
+  }
+
+  return palette_find((GColor8){.argb = PALETTE_LEGACY_ARGB8[legacyIndex]});
+}
+
+#endif
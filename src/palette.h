@@ -0,0 +1,30 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// Color Select palette. A constant table of the 64 color palette less white, which is always
+// the light color. Colors are ordered in groups of similar hue, darkest first within a group.
+// Color platforms only.
+
+#pragma once
+
+#include "pebble.h"
+
+// Palette index of the default dark color, Blue. Keep in step with the table in palette.c.
+#define PALETTE_INDEX_BLUE 42
+
+#ifdef PBL_COLOR
+
+int palette_count();
+GColor palette_color(int index);
+const char *palette_name(int index);
+const char *palette_group_name(int index);
+
+// First color of the group "step" groups after (or before if negative) the group of "index".
+// Stops at the first and last groups.
+int palette_group_first(int index, int step);
+
+// Palette index of a color, or -1 if not in the palette.
+int palette_find(GColor color);
+
+// Palette index of a color selected before the palette was extended, or -1 if out of range.
+int palette_from_legacy(int legacyIndex);
+
+#endif
@@ -0,0 +1,100 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// User settings. See settings.h.
+
+#include "pebble.h"
+#include "settings.h"
+#include "palette.h"
+
+typedef struct settings_S
+{
+  uint16_t resetClearsSplits : 1;
+  uint16_t replaceOldest : 1;
+  uint16_t colorInversion : 1;
+  uint16_t colorSelect : 6; // Palette index.
+} __attribute__((__packed__)) settings_S;
+
+static settings_S settings = {.resetClearsSplits = 1,
+                              .replaceOldest = 0,
+                              .colorInversion = 0,
+                              .colorSelect = PALETTE_INDEX_BLUE};
+
+static SettingsChangeHandler changeHandler = NULL;
+
+
+void settings_set_change_handler(SettingsChangeHandler handler)
+{
+  changeHandler = handler;
+}
+
+
+static void settings_notify(SettingId setting)
+{
+  if (changeHandler != NULL)
+  {
+    changeHandler(setting);
+  }
+}
+
+
+bool settings_get(SettingId setting)
+{
+  if (setting == SETTING_RESET_CLEARS_SPLITS)
+  {
+    return settings.resetClearsSplits;
+  }
+  else if (setting == SETTING_REPLACE_OLDEST)
+  {
+    return settings.replaceOldest;
+  }
+  else if (setting == SETTING_COLOR_INVERSION)
+  {
+    return settings.colorInversion;
+  }
+
+  return false;
+}
+
+
+// Handler is only told of an actual change.
+void settings_set(SettingId setting, bool on)
+{
+  if (settings_get(setting) == on)
+  {
+    return;
+  }
+
+  if (setting == SETTING_RESET_CLEARS_SPLITS)
+  {
+    settings.resetClearsSplits = on;
+  }
+  else if (setting == SETTING_REPLACE_OLDEST)
+  {
+    settings.replaceOldest = on;
+  }
+  else if (setting == SETTING_COLOR_INVERSION)
+  {
+    settings.colorInversion = on;
+  }
+  else
+  {
+    return;
+  }
+
+  settings_notify(setting);
+}
+
+
+int settings_color_select()
+{
+  return settings.colorSelect;
+}
+
+
+void settings_set_color_select(int colorSelect)
+{
+  if (settings.colorSelect != colorSelect)
+  {
+    settings.colorSelect = colorSelect;
+    settings_notify(SETTING_COLOR_SELECT);
+  }
+}
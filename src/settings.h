@@ -0,0 +1,27 @@
+// WatchChronometer (c) 2014 Keith Blom - All rights reserved
+// User settings. Kept as a packed bitfield and only read and written through accessors.
+// Each change is reported to the handler set by settings_set_change_handler().
+
+#pragma once
+
+#include "pebble.h"
+
+typedef enum
+{
+  SETTING_RESET_CLEARS_SPLITS, // Chronometer Reset button also clears splits.
+  SETTING_REPLACE_OLDEST,      // When splits memory is full, replace oldest with new.
+  SETTING_COLOR_INVERSION,     // White text on dark background.
+  SETTING_COLOR_SELECT,        // Palette index of the dark color. Color platforms only.
+} SettingId;
+
+typedef void (*SettingsChangeHandler)(SettingId setting);
+
+void settings_set_change_handler(SettingsChangeHandler handler);
+
+// Yes/No settings.
+bool settings_get(SettingId setting);
+void settings_set(SettingId setting, bool on);
+
+// SETTING_COLOR_SELECT.
+int settings_color_select();
+void settings_set_color_select(int colorSelect);